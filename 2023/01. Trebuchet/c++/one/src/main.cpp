@@ -1,28 +1,19 @@
 #include <algorithm>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
 #include <ranges>
 #include <string>
+#include <string_view>
 
-int main(const int argc, const char** const argv)
-{
-    if (argc != 2)
-    {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
-    }
+#include "solution.hpp"
 
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Failed to open " << std::quoted(argv[1]) << '\n';
-        return 1;
-    }
+namespace
+{
 
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
     int total{};
 
-    for (std::string line; std::getline(infile, line);)
+    for (const std::string_view line : aoc::lines(input))
     {
         // Find first digit and convert from char to int
         const int first{*std::ranges::find_if(line, [](const char c) -> bool
@@ -41,7 +32,9 @@ int main(const int argc, const char** const argv)
         total += assembled;
     }
 
-    std::cout << "Result: " << total << '\n'; 
+    return std::to_string(total);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
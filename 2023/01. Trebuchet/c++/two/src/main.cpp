@@ -1,13 +1,15 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
 #include <ranges>
 #include <string>
 #include <string_view>
 
+#include "solution.hpp"
+
+namespace
+{
+
 static constexpr std::array<std::string_view, 9> DIGIT_STRINGS{
     "one",
     "two",
@@ -20,24 +22,12 @@ static constexpr std::array<std::string_view, 9> DIGIT_STRINGS{
     "nine"
 };
 
-int main(const int argc, const char** const argv)
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    if (argc != 2)
-    {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
-    }
-
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Failed to open " << std::quoted(argv[1]) << '\n';
-        return 1;
-    }
-
     int total{};
 
-    for (std::string line; std::getline(infile, line);)
+    for (const std::string_view line : aoc::lines(input))
     {
         // Find first actual digit
         auto firstIt{std::ranges::find_if(line, [](const char c) -> bool
@@ -103,7 +93,9 @@ int main(const int argc, const char** const argv)
         total += assembled;
     }
 
-    std::cout << "Result: " << total << '\n'; 
+    return std::to_string(total);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,37 +1,7 @@
 #include <ctype.h>
 #include <stdio.h>
-#include <stdlib.h>
 
-/**
- * @brief Scan forward to find length of current line of file
- * 
- * @param file 
- * @return size_t Number of characters before newline or EOF was found
- */
-static size_t nextLineSize(FILE* const file)
-{
-    // Record starting position to restore later
-    const long int starting = ftell(file);
-    if (starting == -1)
-    {
-        perror("ftell() failed");
-        return (size_t)-1;
-    }
-
-    size_t size = 0;
-    
-    // Count characters until newline or EOF
-    for (int c = fgetc(file); c != '\n' && c != EOF; c = fgetc(file))
-    {
-        ++size;
-    }
-
-    // Restore starting file position
-    if (fseek(file, starting, SEEK_SET) != 0)
-        return (size_t)-1;
-    
-    return size;
-}
+#include "utils.h"
 
 int main(const int argc, const char** const argv)
 {
@@ -42,26 +12,22 @@ int main(const int argc, const char** const argv)
     }
 
     FILE* const infile = fopen(argv[1], "r");
+    if (infile == NULL)
+    {
+        fprintf(stderr, "ERROR! Failed to open \"%s\"\n", argv[1]);
+        return 1;
+    }
 
-    // Buffer to store each line
-    char* buffer = NULL;
-    size_t bufferSize = 0;
+    LineReader line;
+    lineReaderCreate(&line, infile);
 
     int total = 0;
 
-    // Read each line of file
-    for (size_t lineSize = nextLineSize(infile); lineSize > 0; lineSize = nextLineSize(infile))
+    // Read each line of file until an empty one
+    while (lineReaderNext(&line) && line.size > 0)
     {
-        // Grow buffer to fit line if needed
-        if (bufferSize < lineSize + 1)
-        {
-            buffer = realloc(buffer, lineSize + 1);
-            bufferSize = lineSize + 1;
-        }
-
-        // Read line
-        fread(buffer, sizeof(char), lineSize + 1, infile);
-        buffer[lineSize] = '\0';
+        const char* const buffer = line.line;
+        const size_t lineSize = line.size;
 
         int first = -1;
         int last = -1;
@@ -100,6 +66,8 @@ int main(const int argc, const char** const argv)
     printf("Result: %d\n", total);
 
 cleanup:
+    lineReaderDestroy(&line);
+
     if (fclose(infile) == EOF)
         fputs("fclose() failed", stderr);
 
@@ -1,18 +1,46 @@
 #include <algorithm>
 #include <array>
-#include <cstring>
-#include <fstream>
+#include <charconv>
 #include <cstddef>
-#include <iomanip>
-#include <iostream>
 #include <iterator>
+#include <stdexcept>
 #include <string>
 #include <string_view>
-#include <vector>
+#include <system_error>
+
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
+{
 
 static constexpr std::string_view DELIMS{" :;,"};
 static const std::size_t NUM_COLORS{3};
 
+/**
+ * @brief Split the next token off the front of str, skipping any DELIMS before it. Works like std::strtok without needing
+ *        a mutable copy of the line
+ *
+ * @param str Advanced past the returned token
+ * @return std::string_view Empty when there are no tokens left
+ */
+static std::string_view nextToken(std::string_view& str)
+{
+    const std::size_t first{str.find_first_not_of(DELIMS)};
+    if (first == std::string_view::npos)
+    {
+        str = {};
+        return {};
+    }
+
+    str.remove_prefix(first);
+
+    const std::string_view token{str.substr(0, str.find_first_of(DELIMS))};
+    str.remove_prefix(token.size());
+
+    return token;
+}
+
 static constexpr std::array<std::string_view, NUM_COLORS> COLOR_STRINGS{
     "red",
     "green",
@@ -25,51 +53,45 @@ static constexpr std::array<int, NUM_COLORS> MAX_CUBES{
     14  // blue
 };
 
-int main(const int argc, const char** const argv)
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    if (argc != 2)
-    {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE\n>";
-        return 1;
-    }
-
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open input file\n";
-        return 1;
-    }
-
     // Puzzle result
     int idSum{};
 
     // Read each line
-    int lineNum{1};
-    for (std::string line; std::getline(infile, line); ++lineNum)
+    int lineNum{};
+    for (const std::string_view line : aoc::lines(input))
     {
+        ++lineNum;
+
         // Minimum number of cubes of each color needed for current game to be possilbe
         std::array<int, NUM_COLORS> minNeeded{};
 
-        // Copy line input mutable buffer for std::strtok
-        std::vector<char> lineBuffer(line.size() + 1);
-        std::copy(line.begin(), line.end(), lineBuffer.begin());
+        // Remaining text of the line, consumed token by token
+        std::string_view rest{line};
 
         // Skip first two tokens
-        std::strtok(lineBuffer.data(), DELIMS.data());
-        std::strtok(nullptr, DELIMS.data());
+        nextToken(rest);
+        nextToken(rest);
 
         // Read ammount, color pairs
-        for (const char* ammountString{std::strtok(nullptr, DELIMS.data())}; ammountString != nullptr; ammountString = std::strtok(nullptr, DELIMS.data()))
+        for (std::string_view ammountString{nextToken(rest)}; !ammountString.empty(); ammountString = nextToken(rest))
         {
-            const int ammount{std::stoi(ammountString)};
-            const std::string_view colorString{std::strtok(nullptr, DELIMS.data())};
+            int ammount{};
+            const auto[last, error]{aoc::fromChars(ammountString.data(), ammountString.data() + ammountString.size(), ammount)};
+            if (error != std::errc{} || last != ammountString.data() + ammountString.size())
+            {
+                throw std::runtime_error{"Invalid ammount \"" + std::string{ammountString} + "\" on line " + std::to_string(lineNum)};
+            }
+
+            const std::string_view colorString{nextToken(rest)};
 
             // Get index for color string or print erorr message if color is not found
             const auto colorIt{std::ranges::find(COLOR_STRINGS, colorString)};
             if (colorIt == COLOR_STRINGS.end())
             {
-                std::cerr << "Unknown color " << std::quoted(colorString) << " on line " << lineNum << '\n';
-                return 1;
+                throw std::runtime_error{"Unknown color \"" + std::string{colorString} + "\" on line " + std::to_string(lineNum)};
             }
             else
             {
@@ -95,7 +117,9 @@ int main(const int argc, const char** const argv)
             idSum += lineNum;
     }
 
-    std::cout << "Result: " << idSum << '\n';
+    return std::to_string(idSum);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
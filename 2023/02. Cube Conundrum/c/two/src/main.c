@@ -28,10 +28,10 @@ int main(const int argc, const char** const argv)
 
     // Read each line
 
-    LineBuffer line;
-    lineBufferCreate(&line);
+    LineReader line;
+    lineReaderCreate(&line, infile);
 
-    for (int lineNum = 1; readNextLine(infile, &line); ++lineNum)
+    for (int lineNum = 1; lineReaderNext(&line); ++lineNum)
     {
         // Minimum number of cubes of each color needed for current game to be possilbe
         int minNeeded[NUM_COLORS] = {0};
@@ -83,7 +83,7 @@ int main(const int argc, const char** const argv)
     printf("Result: %d\n", powerSum);
 
 cleanup:
-    lineBufferDestroy(&line);
+    lineReaderDestroy(&line);
 
     if (fclose(infile) == EOF)
         fputs("fclose() failed\n", stderr);
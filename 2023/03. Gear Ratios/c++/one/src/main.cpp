@@ -1,78 +1,59 @@
 #include <array>
 #include <cctype>
 #include <cstddef>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
+#include <functional>
 #include <iterator>
 #include <numeric>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <vector>
 
-int main(const int argc, const char** const argv)
+#include "grid.hpp"
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
 {
-    if (argc != 2)
-    {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
-    }
 
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open input file " << std::quoted(argv[1]) << '\n';
-        return 1;
-    }
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
 
     // Map of (pointer to start of number, numeric value)
     // Used to prevent the same instance of a number from being added multiple times while still allow the same numeric value to be duplicated
-    std::unordered_map<char*, int> partNumbers;
+    std::unordered_map<const char*, int> partNumbers;
 
-    // Store the grid loaded from the file
-    std::vector<std::vector<char>> grid;
+    // Store the grid loaded from the file, surrounded by empty tiles so neighbors and numbers never run off the edge
+    const aoc::Grid<char> grid{aoc::parseGrid<char>(input, std::identity{}, 1, '.')};
 
     // Lambda to check if a given tile is part of a number and then add that number to partNumbers
     const auto processNeighbor{[&partNumbers, &grid](const std::size_t x, const std::size_t y)
     {
-        // No needed to check less than zero because std::size_t is unsigned
-        if (y >= grid.size() || x >= grid[y].size())
-            return;
-
-        if (std::isdigit(grid[y][x]))
+        if (std::isdigit(grid(x, y)))
         {
             // Find start of number
-            auto first{grid[y].begin() + static_cast<std::ptrdiff_t>(x)};
-            while (first != grid[y].begin() && std::isdigit(*std::prev(first)))
+            const char* first{&grid(x, y)};
+            while (std::isdigit(first[-1]))
             {
                 --first;
             }
 
-            // Find end of number
-            auto last{grid[y].begin() + static_cast<std::ptrdiff_t>(x)};
-            while (last != std::prev(grid[y].end()) && std::isdigit(*std::next(last)))
-            {
-                ++last;
-            }
-
-            // Parse number and add to map
-            const int partNumber{std::stoi(std::string{first, last + 1})};
-            partNumbers.insert({first.base(), partNumber});
+            // Parse number, which stops at the first character that is not a digit, and add to map
+            int partNumber{};
+            aoc::fromChars(first, grid.cellsWithBorder().data() + grid.cellCount(), partNumber);
+            partNumbers.insert({first, partNumber});
         }
     }};
 
-    // Read each line
-    for (std::string line; std::getline(infile, line);)
-    {
-        grid.emplace_back(line.begin(), line.end());
-    }
+    aoc::beginPhase("solve");
 
     // Iterate over all tiles looking for symbols
-    for (std::size_t y{}; y < grid.size(); ++y)
+    for (std::size_t y{}; y < grid.height(); ++y)
     {
-        for (std::size_t x{}; x < grid[y].size(); ++x)
+        for (std::size_t x{}; x < grid.width(); ++x)
         {
-            const char c{grid[y][x]};
+            const char c{grid(x, y)};
 
             if (c != '.' && std::ispunct(c))
             {
@@ -95,7 +76,9 @@ int main(const int argc, const char** const argv)
         partNumberSum += partNumber;
     }
 
-    std::cout << "Result: " << partNumberSum << '\n';
+    return std::to_string(partNumberSum);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -108,23 +108,19 @@ int main(const int argc, const char** const argv)
         return 1;
     }
 
-    // Count lines for memory allocation later
-    const size_t lineCount = countLines(infile);
-    if (lineCount == (size_t)-1)
-    {
-        fputs("Failed to count lines of input file\n", stderr);
-        goto cleanup2;
-    }
+    // Every tile of the grid, one row after another
+    DynamicArray tiles;
+    dynamicArrayCreate(&tiles, sizeof(char));
 
-    char** const grid = malloc(sizeof(char*) * lineCount);
+    char** grid = NULL;
     size_t gridHeight = 0;
     size_t gridWidth = 0;
 
-    LineBuffer line;
-    lineBufferCreate(&line);
+    LineReader line;
+    lineReaderCreate(&line, infile);
 
     // Read file line by line and store them in grid
-    while (readNextLine(infile, &line))
+    while (lineReaderNext(&line))
     {
         if (gridWidth == 0)
             gridWidth = line.size;
@@ -133,15 +129,21 @@ int main(const int argc, const char** const argv)
         if (line.size != gridWidth)
         {
             fputs("ERROR! Inconsistant line lengths", stderr);
-            goto cleanup1;
+            goto cleanup;
         }
 
-        grid[gridHeight] = malloc(sizeof(char) * gridWidth);
-        memcpy(grid[gridHeight], line.line, line.size);
+        dynamicArrayPushBack(&tiles, line.line, line.size);
 
         ++gridHeight;
     }
 
+    // Rows can only be pointed to once every line is read because tiles moves as it grows
+    grid = malloc(sizeof(char*) * gridHeight);
+    for (size_t y = 0; y < gridHeight; ++y)
+    {
+        grid[y] = (char*)tiles.array + y * gridWidth;
+    }
+
     // Puzzle result
     int ratioSum = 0;
 
@@ -182,15 +184,11 @@ int main(const int argc, const char** const argv)
 
     printf("Result: %d\n", ratioSum);
 
-cleanup1:
-    lineBufferDestroy(&line);
+cleanup:
+    lineReaderDestroy(&line);
 
-cleanup2:
-    for (size_t i = 0; i < gridHeight; ++i)
-    {
-        free(grid[i]);
-    }
     free(grid);
+    dynamicArrayDestroy(&tiles);
 
     if (fclose(infile) == EOF)
     {
@@ -1,27 +1,20 @@
 #include <algorithm>
 #include <cstddef>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
-#include <limits>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <vector>
 
-int main(const int argc, const char** const argv)
-{
-    if (argc != 2)
-    {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
-    }
+#include "parse.hpp"
+#include "solution.hpp"
 
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Failed to open " << std::quoted(argv[1]) << '\n';
-        return 1;
-    }
+namespace
+{
 
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
     // Puzzle result
     int cardCount{};
 
@@ -32,50 +25,41 @@ int main(const int argc, const char** const argv)
     // Number of extra copies to add for the next card is present in front
     std::vector<int> copies;
 
-    std::size_t lineNum{1};
-    for (std::string line; std::getline(infile, line); ++lineNum, presentNumbers.clear(), winningNumbers.clear())
+    std::size_t lineNum{};
+    for (const std::string_view line : aoc::lines(input))
     {
-        std::istringstream ss{line};
-        
-        // Check for "Card" string
-        ss >> line;
-        if (line != "Card")
-        {
-            std::cerr << "Line " << lineNum << " is invalied\n";
-            return 1;
-        }
+        ++lineNum;
+        presentNumbers.clear();
+        winningNumbers.clear();
 
-        // Check card number matches expected
-        int cardNum;
-        ss >> cardNum;
-        if (cardNum != static_cast<int>(lineNum))
+        // Check for "Card" string
+        if (!line.starts_with("Card"))
         {
-            std::cerr << "Invalid card number on line " << lineNum << '\n';
-            return 1;
+            throw std::runtime_error{"Line " + std::to_string(lineNum) + " is invalied"};
         }
 
         // Check for colon to mark start of present numbers
-        if (ss.get() != ':')
+        const std::size_t colonPos{line.find(':')};
+        if (colonPos == std::string_view::npos)
         {
-            std::cerr << "Expected colon on line " << lineNum << '\n';
-            return 1;
+            throw std::runtime_error{"Expected colon on line " + std::to_string(lineNum)};
         }
 
-        // Read all present numbers. '|' triggers failure that will be cleared after loop
-        for (int number; ss >> number;)
+        // Check card number matches expected. It is the last word before the colon
+        const std::string_view cardLabel{line.substr(0, colonPos)};
+        const std::size_t cardNumPos{cardLabel.find_last_of(' ') + 1};
+        int cardNum{};
+        if (aoc::fromChars(cardLabel.data() + cardNumPos, cardLabel.data() + cardLabel.size(), cardNum).ec != std::errc{} ||
+            cardNum != static_cast<int>(lineNum))
         {
-            presentNumbers.push_back(number);
+            throw std::runtime_error{"Invalid card number on line " + std::to_string(lineNum)};
         }
-        ss.clear();
 
-        // Find and remove pipe
-        ss.ignore(std::numeric_limits<std::streamsize>::max(), '|');
-
-        // Read all winning numbers
-        for (int number; ss >> number;)
-        {
-            winningNumbers.push_back(number);
-        }
+        // Present numbers run from the colon to the pipe, and winning numbers from the pipe to the end of the line
+        const std::size_t pipePos{line.find('|', colonPos)};
+        aoc::parseInts(line.substr(colonPos + 1, pipePos - (colonPos + 1)), presentNumbers);
+        if (pipePos != std::string_view::npos)
+            aoc::parseInts(line.substr(pipePos + 1), winningNumbers);
 
         // Sort for binary search for fast lookup
         std::ranges::sort(winningNumbers);
@@ -107,7 +91,9 @@ int main(const int argc, const char** const argv)
         }
     }
 
-    std::cout << "Result: " << cardCount << '\n';
+    return std::to_string(cardCount);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
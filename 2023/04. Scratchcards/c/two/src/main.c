@@ -52,10 +52,10 @@ int main(const int argc, const char** const argv)
 
     // Read each line
 
-    LineBuffer line;
-    lineBufferCreate(&line);
+    LineReader line;
+    lineReaderCreate(&line, infile);
 
-    for (size_t lineNum = 0; readNextLine(infile, &line); ++lineNum, dynamicArrayClear(&presentNumbers), dynamicArrayClear(&winningNumbers))
+    for (size_t lineNum = 0; lineReaderNext(&line); ++lineNum, dynamicArrayClear(&presentNumbers), dynamicArrayClear(&winningNumbers))
     {
         // Total bytes read of line. Updated after every read
         ptrdiff_t bytesRead = 0;
@@ -132,5 +132,5 @@ cleanup:
     dynamicArrayDestroy(&presentNumbers);
     dynamicArrayDestroy(&winningNumbers);
 
-    lineBufferDestroy(&line);
+    lineReaderDestroy(&line);
 }
\ No newline at end of file
@@ -1,100 +1,94 @@
 #include <algorithm>
 #include <cstddef>
-#include <fstream>
-#include <iostream>
-#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
 /**
  * @brief Read list of seed numbers
  * 
- * @param infile 
+ * @param line 
  * @return std::vector<unsigned long long int> 
  */
 [[nodiscard]]
-static std::vector<unsigned long long int> readSeeds(std::istream& infile)
+static std::vector<unsigned long long int> readSeeds(const std::string_view line)
 {
-    std::vector<unsigned long long int> seeds;
-
-    std::string str;
-    std::getline(infile, str);
-
-    std::istringstream ss{str};
-
-    // Read and verify seed line start
-    ss >> str;
-    if (str != "seeds:")
+    // Verify seed line start
+    if (!line.starts_with("seeds:"))
     {
         return {};
     }
 
     // Read actual seed numbers
-    for (unsigned long long int seed; ss >> seed;)
-    {
-        seeds.push_back(seed);
-    }
-
-    return seeds;
+    return aoc::parseInts<unsigned long long int>(line);
 }
 
-int main(const int argc, const char** const argv)
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    if (argc != 2)
-    {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
-    }
+    aoc::beginPhase("parse");
 
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Failed to open input file\n";
-        return 1;
-    }
+    auto line{aoc::lines(input).begin()};
+
+    std::vector<unsigned long long int> seeds{readSeeds(*line++)};
 
-    std::vector<unsigned long long int> seeds{readSeeds(infile)};
+    aoc::beginPhase("solve");
 
     // Flag to check if a seed at a given index has been converted yet by the current map. All set to false every iteration below
     std::vector<bool> seedConverted(seeds.size());
 
-    for (std::string text; infile >> text;)
+    // Numbers of the current mapping line. Cleared before each line
+    std::vector<unsigned long long int> mapping;
+
+    for (; line != std::default_sentinel; ++line)
     {
-        // Reset all conversion flags
-        std::fill(seedConverted.begin(), seedConverted.end(), false);
+        const std::string_view text{*line};
+        if (text.empty())
+            continue;
 
-        // Read and verify start of line
-        infile >> text;
-        if (text != "map:")
+        // Start of the next map
+        if (text.ends_with("map:"))
         {
-            std::cerr << "ERROR! Invalid input\n";
-            return 1;
+            // Reset all conversion flags
+            std::fill(seedConverted.begin(), seedConverted.end(), false);
+            continue;
         }
 
         // For each mapping
-        unsigned long long int destStart;
-        unsigned long long int srcStart;
-        unsigned long long int size;
-        while (infile >> destStart >> srcStart >> size)
+        mapping.clear();
+        aoc::parseInts(text, mapping);
+        if (mapping.size() != 3)
+        {
+            throw std::runtime_error{"Invalid input"};
+        }
+
+        const unsigned long long int destStart{mapping[0]};
+        const unsigned long long int srcStart{mapping[1]};
+        const unsigned long long int size{mapping[2]};
+
+        // For each seed that's not been converted this iteration, convert if necessary
+        for (std::size_t i{}; i < seeds.size(); ++i)
         {
-            // For each seed that's not been converted this iteration, convert if necessary
-            for (std::size_t i{}; i < seeds.size(); ++i)
+            unsigned long long int& seed{seeds[i]};
+            if (!seedConverted[i] && seed >= srcStart && seed < srcStart + size)
             {
-                unsigned long long int& seed{seeds[i]};
-                if (!seedConverted[i] && seed >= srcStart && seed < srcStart + size)
-                {
-                    seedConverted[i] = true;
-                    seed = destStart + seed - srcStart;
-                }
+                seedConverted[i] = true;
+                seed = destStart + seed - srcStart;
             }
         }
-
-        // while loop will error when numbers run out
-        infile.clear();
     }
 
-    std::cout << "Result: " << *std::ranges::min_element(seeds) << '\n';
+    return std::to_string(*std::ranges::min_element(seeds));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,141 +1,298 @@
 #include <algorithm>
-#include <cmath>
+#include <bit>
 #include <cstddef>
-#include <fstream>
-#include <iostream>
 #include <limits>
-#include <sstream>
+#include <stdexcept>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
 struct SeedRange
 {
     long long int start{};
     long long int size{};
 };
 
+/**
+ * @brief Piecewise linear function stored as sorted, non-overlapping pieces that together cover [0, DOMAIN_END)
+ *        Every value in a piece is shifted by that piece's offset, and neighboring pieces with the same offset are merged
+ *
+ */
+class IntervalMap
+{
+public:
+    // Far beyond any puzzle value, yet small enough that adding up the offsets of every map can not overflow
+    static constexpr long long int DOMAIN_END{std::numeric_limits<long long int>::max() / 4};
+
+    // Maps [start, end) to [start + offset, end + offset)
+    struct Piece
+    {
+        long long int start{};
+        long long int end{};
+        long long int offset{};
+    };
+
+    /**
+     * @brief Map every value to itself
+     *
+     */
+    IntervalMap()
+    {
+        this->append({0, DOMAIN_END, 0});
+        this->buildLowestImages();
+    }
+
+    /**
+     * @brief Map values in each of mappings by its offset and all others to themselves
+     *        std::runtime_error will be thrown if mappings overlap or reach outside [0, DOMAIN_END)
+     *
+     * @param mappings
+     */
+    explicit IntervalMap(std::vector<Piece> mappings)
+    {
+        std::ranges::sort(mappings, {}, &Piece::start);
+
+        long long int covered{0};
+        for (const Piece& mapping : mappings)
+        {
+            if (mapping.start < covered || mapping.end > DOMAIN_END || mapping.start + mapping.offset < 0 ||
+                mapping.end + mapping.offset > DOMAIN_END)
+                throw std::runtime_error{"Map ranges must not overlap or be negative"};
+
+            if (mapping.start == mapping.end)
+                continue;
+
+            // Values between mappings are unchanged
+            if (covered < mapping.start)
+                this->append({covered, mapping.start, 0});
+
+            this->append(mapping);
+            covered = mapping.end;
+        }
+
+        if (covered < DOMAIN_END)
+            this->append({covered, DOMAIN_END, 0});
+
+        this->buildLowestImages();
+    }
+
+    /**
+     * @brief Combine this map and next into one map that gives the same results as applying this and then next
+     *        Each piece of this is split wherever its image crosses into another piece of next
+     *
+     * @param next
+     * @return IntervalMap
+     */
+    [[nodiscard]]
+    IntervalMap then(const IntervalMap& next) const
+    {
+        IntervalMap result;
+        result.pieces.clear();
+
+        for (const Piece& piece : this->pieces)
+        {
+            std::size_t target{next.pieceIndex(piece.start + piece.offset)};
+
+            for (long long int start{piece.start}; start < piece.end; ++target)
+            {
+                const Piece& nextPiece{next.pieces[target]};
+                const long long int end{std::min(piece.end, nextPiece.end - piece.offset)};
+
+                result.append({start, end, piece.offset + nextPiece.offset});
+                start = end;
+            }
+        }
+
+        result.buildLowestImages();
+
+        return result;
+    }
+
+    /**
+     * @brief Smallest value anything in [first, last) maps to, in O(log n) no matter how many pieces the range covers
+     *
+     * @param first
+     * @param last Must be greater than first
+     * @return long long int
+     */
+    [[nodiscard]]
+    long long int lowestImage(const long long int first, const long long int last) const
+    {
+        const std::size_t firstPiece{this->pieceIndex(first)};
+        const std::size_t lastPiece{this->pieceIndex(last - 1)};
+
+        // Pieces only shift values, so the lowest image in any part of a piece is the image of the start of that part
+        long long int lowest{first + this->pieces[firstPiece].offset};
+        if (firstPiece == lastPiece)
+            return lowest;
+
+        // Pieces in between are covered entirely
+        lowest = std::min(lowest, this->lowestImageOfPieces(firstPiece + 1, lastPiece + 1));
+
+        return lowest;
+    }
+private:
+    std::vector<Piece> pieces;
+
+    // Sparse table where lowestImages[k][i] is the lowest image of pieces [i, i + 2^k)
+    std::vector<std::vector<long long int>> lowestImages;
+
+    void append(const Piece& piece)
+    {
+        if (!this->pieces.empty() && this->pieces.back().end == piece.start && this->pieces.back().offset == piece.offset)
+            this->pieces.back().end = piece.end;
+        else
+            this->pieces.push_back(piece);
+    }
+
+    [[nodiscard]]
+    std::size_t pieceIndex(const long long int value) const
+    {
+        if (value < 0 || value >= DOMAIN_END)
+            throw std::runtime_error{std::to_string(value) + " is outside of the map"};
+
+        const auto after{std::ranges::upper_bound(this->pieces, value, {}, &Piece::start)};
+        return static_cast<std::size_t>(after - this->pieces.begin()) - 1;
+    }
+
+    void buildLowestImages()
+    {
+        this->lowestImages.assign(1, {});
+        for (const Piece& piece : this->pieces)
+        {
+            this->lowestImages[0].push_back(piece.start + piece.offset);
+        }
+
+        for (std::size_t width{2}; width <= this->pieces.size(); width *= 2)
+        {
+            const std::vector<long long int>& half{this->lowestImages.back()};
+
+            std::vector<long long int> level(this->pieces.size() - width + 1);
+            for (std::size_t i{}; i < level.size(); ++i)
+            {
+                level[i] = std::min(half[i], half[i + width / 2]);
+            }
+
+            this->lowestImages.push_back(std::move(level));
+        }
+    }
+
+    /**
+     * @brief Lowest image of pieces [first, last) from two overlapping sparse table entries
+     *
+     * @param first
+     * @param last Must be greater than first
+     * @return long long int
+     */
+    [[nodiscard]]
+    long long int lowestImageOfPieces(const std::size_t first, const std::size_t last) const
+    {
+        const std::size_t level{std::bit_width(last - first) - 1};
+        const std::size_t width{std::size_t{1} << level};
+
+        return std::min(this->lowestImages[level][first], this->lowestImages[level][last - width]);
+    }
+};
+
 /**
  * @brief Read list of seed ranges
- * 
- * @param infile 
+ *
+ * @param line
  * @return std::vector<SeedRange>
  */
 [[nodiscard]]
-static std::vector<SeedRange> readSeeds(std::istream& infile)
+static std::vector<SeedRange> readSeeds(const std::string_view line)
 {
     std::vector<SeedRange> seeds;
 
-    std::string str;
-    std::getline(infile, str);
-
-    std::istringstream ss{str};
-
-    // Read and verify seed line start
-    ss >> str;
-    if (str != "seeds:")
+    // Verify seed line start
+    if (!line.starts_with("seeds:"))
     {
         return {};
     }
 
-    // Read actual seed numbers
-    for (long long int start, size; ss >> start >> size;)
+    // Read actual seed numbers, which come in pairs of start and size
+    const std::vector<long long int> numbers{aoc::parseInts<long long int>(line)};
+    for (std::size_t i{}; i + 1 < numbers.size(); i += 2)
     {
-        seeds.emplace_back(start, size);
+        seeds.emplace_back(numbers[i], numbers[i + 1]);
     }
 
     return seeds;
 }
 
-int main(const int argc, const char** const argv)
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    if (argc != 2)
-    {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
-    }
+    aoc::beginPhase("parse");
+
+    auto line{aoc::lines(input).begin()};
 
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
+    const std::vector<SeedRange> seeds{readSeeds(*line++)};
+    if (seeds.empty())
     {
-        std::cerr << "ERROR! Failed to open input file\n";
-        return 1;
+        throw std::runtime_error{"No seeds to plant"};
     }
 
-    std::vector<SeedRange> seeds{readSeeds(infile)};
+    // Mappings of each map in order
+    std::vector<std::vector<IntervalMap::Piece>> maps;
 
-    // Flags to check if a seed at a given index has been converted yet by the current map. All flags set to false at start of each map
-    std::vector<bool> rangeConverted(seeds.size());
+    // Numbers of the current mapping line. Cleared before each line
+    std::vector<long long int> mapping;
 
-    // New breakaway ranges to insert into seeds after each seed is converted. Cleared after insertion
-    std::vector<SeedRange> newSeeds;
-
-    // For each mapping
-    for (std::string text; infile >> text;)
+    for (; line != std::default_sentinel; ++line)
     {
-        // No seeds have been converted yet at the start of this mapping
-        std::fill(rangeConverted.begin(), rangeConverted.end(), false);
-        
-        // Read and verify start of line
-        infile >> text;
-        if (text != "map:")
+        const std::string_view text{*line};
+        if (text.empty())
+            continue;
+
+        // Start of the next map
+        if (text.ends_with("map:"))
         {
-            std::cerr << "ERROR! Invalid input\n";
-            return 1;
+            maps.emplace_back();
+            continue;
         }
 
-        // For each mapping in map
-        long long int destStart;
-        long long int srcStart;
-        long long int size;
-        while (infile >> destStart >> srcStart >> size)
+        mapping.clear();
+        aoc::parseInts(text, mapping);
+        if (mapping.size() != 3 || maps.empty())
         {
-            // For each seed range that's not been converted this iteration, convert if necessary
-            for (std::size_t i{}; i < seeds.size(); ++i)
-            {
-                SeedRange& startingRange{seeds[i]};
-
-                // Skip already converted ranges
-                if (rangeConverted[i])
-                    continue;
-
-                // If any part of this range should be converted
-                if (startingRange.start + startingRange.size - 1 >= srcStart && startingRange.start < srcStart + size)
-                {
-                    // Break off portion before start of conversion area
-                    if (startingRange.start < srcStart)
-                    {
-                        newSeeds.emplace_back(startingRange.start, srcStart - startingRange.start);
-                        startingRange.size -= srcStart - startingRange.start;
-                        startingRange.start = srcStart;
-                    }
-
-                    // Break off portion before after end of conversion area
-                    if (startingRange.start + startingRange.size > srcStart + size)
-                    {
-                        newSeeds.emplace_back(srcStart + size, startingRange.start + startingRange.size - (srcStart + size));
-                        startingRange.size -= startingRange.start + startingRange.size - (srcStart + size);
-                    }
-
-                    // Convert remaining portion
-                    startingRange.start = destStart + startingRange.start - srcStart;
-                    rangeConverted[i] = true;
-
-                    // Insert any new seed ranges from above breakaway code
-                    seeds.insert(seeds.end(), newSeeds.begin(), newSeeds.end());
-                    newSeeds.clear();
-
-                    // Resize to match current seed count
-                    rangeConverted.resize(seeds.size());
-                }
-            }
+            throw std::runtime_error{"Invalid input"};
         }
 
-        // Map while loop will error when numbers run out
-        infile.clear();
+        const long long int destStart{mapping[0]};
+        const long long int srcStart{mapping[1]};
+        const long long int size{mapping[2]};
+
+        maps.back().emplace_back(srcStart, srcStart + size, destStart - srcStart);
     }
 
-    std::cout << "Result: " << std::ranges::min_element(seeds, std::less{}, &SeedRange::start)->start << '\n';
+    aoc::beginPhase("solve");
+
+    // Seed to location in one map, so each seed range is a single lookup no matter how many maps there are
+    IntervalMap seedToLocation;
+    for (std::vector<IntervalMap::Piece>& mappings : maps)
+    {
+        seedToLocation = seedToLocation.then(IntervalMap{std::move(mappings)});
+    }
+
+    long long int lowestLocation{std::numeric_limits<long long int>::max()};
+    for (const SeedRange& seed : seeds)
+    {
+        if (seed.size > 0)
+            lowestLocation = std::min(lowestLocation, seedToLocation.lowestImage(seed.start, seed.start + seed.size));
+    }
+
+    return std::to_string(lowestLocation);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
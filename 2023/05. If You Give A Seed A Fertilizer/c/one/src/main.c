@@ -1,5 +1,6 @@
 #include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "utils.h"
@@ -19,12 +20,14 @@ int main(const int argc, const char** const argv)
         return 1;
     }
 
+    LineReader line;
+    lineReaderCreate(&line, infile);
+
     // Verify start of seed line
-    int bytesRead = 0;
-    fscanf(infile, "seeds: %n", &bytesRead);
-    if (bytesRead != 7)
+    if (!lineReaderNext(&line) || strncmp(line.line, "seeds: ", 7) != 0)
     {
         fputs("ERROR! Failed to read seeds list\n", stderr);
+        lineReaderDestroy(&line);
         fclose(infile);
         return 1;
     }
@@ -36,8 +39,12 @@ int main(const int argc, const char** const argv)
     dynamicArrayCreate(&seeds, sizeof(unsigned long long int));
 
     // Read seeds
-    for (unsigned long long int seed; fscanf(infile, "%llu", &seed) == 1;)
+    for (char* next = line.line + 7, * end = NULL;; next = end)
     {
+        const unsigned long long int seed = strtoull(next, &end, 10);
+        if (end == next)
+            break;
+
         dynamicArrayPushBack(&seeds, &seed, 1);
     }
 
@@ -47,12 +54,9 @@ int main(const int argc, const char** const argv)
     dynamicArrayCreate(&seedConverted, sizeof(unsigned char));
     dynamicArrayResize(&seedConverted, seeds.size);
 
-    // Read each line
-
-    LineBuffer line;
-    lineBufferCreate(&line);
+    // Read each line after the seeds
 
-    for (int lineNum = 1; readNextLine(infile, &line); ++lineNum)
+    for (int lineNum = 2; lineReaderNext(&line); ++lineNum)
     {
         // Skip empty lines
         if (line.size == 0)
@@ -94,7 +98,7 @@ int main(const int argc, const char** const argv)
     printf("Result: %llu\n", *minull((const unsigned long long int*)seeds.array, seeds.size));
 
 cleanup:
-    lineBufferDestroy(&line);
+    lineReaderDestroy(&line);
 
     dynamicArrayDestroy(&seedConverted);
     dynamicArrayDestroy(&seeds);
@@ -1,5 +1,6 @@
 #include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "utils.h"
@@ -41,12 +42,14 @@ int main(const int argc, const char** const argv)
         return 1;
     }
 
+    LineReader line;
+    lineReaderCreate(&line, infile);
+
     // Verify start of seed line
-    int bytesRead = 0;
-    fscanf(infile, "seeds: %n", &bytesRead);
-    if (bytesRead != 7)
+    if (!lineReaderNext(&line) || strncmp(line.line, "seeds: ", 7) != 0)
     {
         fputs("ERROR! Failed to read seeds list\n", stderr);
+        lineReaderDestroy(&line);
         fclose(infile);
         return 1;
     }
@@ -58,8 +61,17 @@ int main(const int argc, const char** const argv)
     dynamicArrayCreate(&seeds, sizeof(SeedRange));
 
     // Read seed ranges
-    for (long long int start, size; fscanf(infile, "%lld %lld", &start, &size) == 2;)
+    for (char* next = line.line + 7, * end = NULL;; next = end)
     {
+        const long long int start = strtoll(next, &end, 10);
+        if (end == next)
+            break;
+
+        next = end;
+        const long long int size = strtoll(next, &end, 10);
+        if (end == next)
+            break;
+
         const SeedRange range = {.start = start, .size = size};
         dynamicArrayPushBack(&seeds, &range, 1);
     }
@@ -74,12 +86,9 @@ int main(const int argc, const char** const argv)
     DynamicArray newSeeds;
     dynamicArrayCreate(&newSeeds, sizeof(SeedRange));
 
-    // Read each line
-
-    LineBuffer line;
-    lineBufferCreate(&line);
+    // Read each line after the seeds
 
-    for (int lineNum = 1; readNextLine(infile, &line); ++lineNum)
+    for (int lineNum = 2; lineReaderNext(&line); ++lineNum)
     {
         // Skip empty lines
         if (line.size == 0)
@@ -153,7 +162,7 @@ int main(const int argc, const char** const argv)
     printf("Result: %lld\n", ((const SeedRange*)min(seeds.array, sizeof(SeedRange), seeds.size, seedRangeLessThan))->start);
 
 cleanup:
-    lineBufferDestroy(&line);
+    lineReaderDestroy(&line);
 
     dynamicArrayDestroy(&newSeeds);
     dynamicArrayDestroy(&rangeConverted);
@@ -1,130 +1,209 @@
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
+#include <cstdint>
+#include <limits>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
+// Large enough for any time below 2^64 and its best distance
+__extension__ using Integer = unsigned __int128;
+
 struct Race
 {
-    long long int time{};
-    long long int distance{};
+    Integer time{};
+    Integer distance{};
 };
 
 /**
- * @brief Insert a series of time values from infile in the format of "Time: 7 15 30" into races
+ * @brief Insert a series of time values from line in the format of "Time: 7 15 30" into races
  *        Only the "time" fields of each race will be set. Distances will all be zero
- *        std::runtime error will be thrown if infile does not start with a string
+ *        std::runtime error will be thrown if line does not start with "Time:"
  * 
- * @param infile 
+ * @param line 
  * @param races 
  */
-static void readTimes(std::ifstream& infile, std::vector<Race>& races)
+static void readTimes(const std::string_view line, std::vector<Race>& races)
 {
-    std::string str;
-    if (!(infile >> str))
+    if (!line.starts_with("Time:"))
         throw std::runtime_error{"Time data in invalid"};
 
-    for (long long int time; infile >> time;)
+    for (const Integer time : aoc::parseInts<Integer>(line))
     {
         races.emplace_back(time);
     }
-    infile.clear();
 }
 
 /**
- * @brief Read a series of distance values from infile in the format of "Distance: 7 15 30" into races
+ * @brief Read a series of distance values from line in the format of "Distance: 7 15 30" into races
  *        Values will be read until either input runs out of distances or races runs out of races
- *        std::runtime error will be thrown if infile does not start with a string
+ *        std::runtime error will be thrown if line does not start with "Distance:"
  * 
- * @param infile 
+ * @param line 
  * @param races 
  */
-static void readDistances(std::ifstream& infile, std::vector<Race>& races)
+static void readDistances(const std::string_view line, std::vector<Race>& races)
 {
-    std::string str;
-    if (!(infile >> str))
+    if (!line.starts_with("Distance:"))
         throw std::runtime_error{"Distance data in invalid"};
 
-    for (std::size_t i{}; i < races.size() && infile >> races[i].distance; ++i);
-    infile.clear();
+    const std::vector<Integer> distances{aoc::parseInts<Integer>(line)};
+    for (std::size_t i{}; i < races.size() && i < distances.size(); ++i)
+    {
+        races[i].distance = distances[i];
+    }
 }
 
 /**
- * @brief Read race time and distance values from infile in the format of
+ * @brief Read race time and distance values from input in the format of
  *        Time:      7  15   30
 *         Distance:  9  40  200
  * 
- * @param infile 
+ * @param input 
  * @return std::vector<Race> 
  */
 [[nodiscard]]
-static std::vector<Race> readRaces(std::ifstream& infile)
+static std::vector<Race> readRaces(const std::string_view input)
 {
     std::vector<Race> races;
 
-    readTimes(infile, races);
-    readDistances(infile, races);
+    // A missing line reads as empty, which both readers reject
+    auto line{aoc::lines(input).begin()};
+    readTimes(*line++, races);
+    readDistances(*line, races);
 
     return races;
 }
 
 /**
- * @brief Calcualte the number of possible ways to win race
+ * @brief Largest root with root * root <= value. Starts from a floating point estimate, then steps to the exact answer
  * 
- * @param race 
- * @return unsigned long long int 
+ * @param value 
+ * @return Integer 
  */
 [[nodiscard]]
-static unsigned long long int winMethods(const Race& race)
+static Integer isqrt(const Integer value)
 {
-    unsigned long long int methods{};
+    if (value == 0)
+        return 0;
+
+    Integer root{static_cast<Integer>(std::sqrt(static_cast<long double>(value)))};
 
-    // After the first win, any loss means we can't hold for any longer and still win, so abort
-    bool firstWin{false};
-    for (long long int hold{1}; hold <= race.time; ++hold)
+    // Compare by dividing so squaring a root near 2^64 can not overflow
+    while (root > value / root)
+    {
+        --root;
+    }
+    while (root + 1 <= value / (root + 1))
     {
-        if ((race.time - hold) * hold > race.distance)
-        {
-            firstWin = true;
-            ++methods;
-        }
-        else if (firstWin)
-        {
-            break;
-        }
+        ++root;
     }
 
-    return methods;
+    return root;
 }
 
-int main(const int argc, const char** const argv)
+/**
+ * @brief Calcualte the number of possible ways to win race without trying every hold time
+ *        Holding for h wins when (time - h) * h > distance, which is true strictly between the roots of
+ *        h^2 - time * h + distance. Wins are symmetric around time / 2, so only the first winning hold is needed
+ *        std::runtime_error will be thrown if time is 2^64 or more
+ * 
+ * @param race 
+ * @return Integer 
+ */
+[[nodiscard]]
+static Integer winMethods(const Race& race)
 {
-    if (argc != 2)
+    if (race.time > std::numeric_limits<std::uint64_t>::max())
+        throw std::runtime_error{"Race time must be less than 2^64"};
+
+    const Integer square{race.time * race.time};
+
+    // Holding for half the time is the best possible, so there are no wins if that can't beat the distance
+    if (square / 4 <= race.distance)
+        return 0;
+
+    // Rounding of the root can land one off either side of the first winning hold
+    Integer hold{(race.time - isqrt(square - 4 * race.distance)) / 2};
+    while ((race.time - hold) * hold <= race.distance)
+    {
+        ++hold;
+    }
+    while (hold > 0 && (race.time - (hold - 1)) * (hold - 1) > race.distance)
     {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
+        --hold;
     }
 
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
+    return race.time - 2 * hold + 1;
+}
+
+/**
+ * @brief Number of ways to win each of races
+ * 
+ * @param races 
+ * @return std::vector<Integer> 
+ */
+[[nodiscard]]
+static std::vector<Integer> winMethods(const std::vector<Race>& races)
+{
+    std::vector<Integer> methods(races.size());
+    for (std::size_t i{}; i < races.size(); ++i)
     {
-        std::cerr << "ERROR! Failed to open " << std::quoted(argv[1]) << '\n';
-        return 1;
+        methods[i] = winMethods(races[i]);
     }
 
-    std::vector<Race> races{readRaces(infile)};
-    infile.close();
+    return methods;
+}
+
+/**
+ * @brief std::to_string for Integer
+ * 
+ * @param value 
+ * @return std::string 
+ */
+[[nodiscard]]
+static std::string toString(Integer value)
+{
+    std::string result;
+    do
+    {
+        result.push_back(static_cast<char>('0' + static_cast<int>(value % 10)));
+        value /= 10;
+    } while (value != 0);
+
+    std::ranges::reverse(result);
+
+    return result;
+}
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    std::vector<Race> races{readRaces(input)};
+
+    aoc::beginPhase("solve");
 
     // Product of all the win method counts
-    unsigned long long int result{1};
+    Integer result{1};
 
-    for (const Race& race : races)
+    for (const Integer methods : winMethods(races))
     {
-        result *= winMethods(race);
+        result *= methods;
     }
 
-    std::cout << "Result: " << result << '\n';
+    return toString(result);
+}
 
-    return 0;
 }
+
+AOC_SOLUTION(solve)
\ No newline at end of file
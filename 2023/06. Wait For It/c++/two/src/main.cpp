@@ -1,116 +1,173 @@
+#include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <cstddef>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
+#include <cstdint>
 #include <limits>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "solution.hpp"
+
+namespace
+{
+
+// Large enough for any time below 2^64 and its best distance
+__extension__ using Integer = unsigned __int128;
+
 struct Race
 {
-    long long int time{};
-    long long int distance{};
+    Integer time{};
+    Integer distance{};
 };
 
 /**
- * @brief Converts string containing digits, combines all digits into one string, and converts that to a number with std::stoll
+ * @brief Combines all digits in str into one number, ignoring anything else
+ *        std::runtime_error will be thrown if there are no digits or the number does not fit in an Integer
  * 
  * @param str 
- * @return long long int 
+ * @return Integer 
  */
-long long int combineNumberPortions(const std::string& str)
+[[nodiscard]]
+static Integer combineNumberPortions(const std::string_view str)
 {
-    std::string combinded;
+    Integer result{};
+    bool anyDigits{false};
+
     for (const char c : str)
     {
-        if (std::isdigit(c))
-            combinded.push_back(c);
+        if (!std::isdigit(c))
+            continue;
+
+        if (__builtin_mul_overflow(result, 10, &result) || __builtin_add_overflow(result, c - '0', &result))
+            throw std::runtime_error{"\"" + std::string{str} + "\" is too large"};
+
+        anyDigits = true;
     }
 
-    return std::stoll(combinded);
+    if (!anyDigits)
+        throw std::runtime_error{"No digits in \"" + std::string{str} + '"'};
+
+    return result;
 }
 
 /**
- * @brief Calcualte the number of possible ways to win race
+ * @brief Largest root with root * root <= value. Starts from a floating point estimate, then steps to the exact answer
  * 
- * @param race 
- * @return unsigned long long int 
+ * @param value 
+ * @return Integer 
  */
 [[nodiscard]]
-static unsigned long long int winMethods(const Race& race)
+static Integer isqrt(const Integer value)
 {
-    unsigned long long int methods{};
+    if (value == 0)
+        return 0;
+
+    Integer root{static_cast<Integer>(std::sqrt(static_cast<long double>(value)))};
 
-    // After the first win, any loss means we can't hold for any longer and still win, so abort
-    bool firstWin{false};
-    for (long long int hold{1}; hold <= race.time; ++hold)
+    // Compare by dividing so squaring a root near 2^64 can not overflow
+    while (root > value / root)
     {
-        if ((race.time - hold) * hold > race.distance)
-        {
-            firstWin = true;
-            ++methods;
-        }
-        else if (firstWin)
-        {
-            break;
-        }
+        --root;
+    }
+    while (root + 1 <= value / (root + 1))
+    {
+        ++root;
     }
 
-    return methods;
+    return root;
 }
 
-int main(const int argc, const char** const argv)
+/**
+ * @brief Calcualte the number of possible ways to win race without trying every hold time
+ *        Holding for h wins when (time - h) * h > distance, which is true strictly between the roots of
+ *        h^2 - time * h + distance. Wins are symmetric around time / 2, so only the first winning hold is needed
+ *        std::runtime_error will be thrown if time is 2^64 or more
+ * 
+ * @param race 
+ * @return Integer 
+ */
+[[nodiscard]]
+static Integer winMethods(const Race& race)
 {
-    if (argc != 2)
+    if (race.time > std::numeric_limits<std::uint64_t>::max())
+        throw std::runtime_error{"Race time must be less than 2^64"};
+
+    const Integer square{race.time * race.time};
+
+    // Holding for half the time is the best possible, so there are no wins if that can't beat the distance
+    if (square / 4 <= race.distance)
+        return 0;
+
+    // Rounding of the root can land one off either side of the first winning hold
+    Integer hold{(race.time - isqrt(square - 4 * race.distance)) / 2};
+    while ((race.time - hold) * hold <= race.distance)
     {
-        std::cerr << "Usage: " << argv[0] << " <INPUT_FILE>\n";
-        return 1;
+        ++hold;
     }
-
-    std::ifstream infile{argv[1]};
-    if (!infile.is_open())
+    while (hold > 0 && (race.time - (hold - 1)) * (hold - 1) > race.distance)
     {
-        std::cerr << "ERROR! Failed to open " << std::quoted(argv[1]) << '\n';
-        return 1;
+        --hold;
     }
 
-    std::string start;
-    std::string numbers;
+    return race.time - 2 * hold + 1;
+}
+
+/**
+ * @brief std::to_string for Integer
+ * 
+ * @param value 
+ * @return std::string 
+ */
+[[nodiscard]]
+static std::string toString(Integer value)
+{
+    std::string result;
+    do
+    {
+        result.push_back(static_cast<char>('0' + static_cast<int>(value % 10)));
+        value /= 10;
+    } while (value != 0);
+
+    std::ranges::reverse(result);
+
+    return result;
+}
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    auto line{aoc::lines(input).begin()};
 
     Race race;
 
     // Read times
-    if (!(infile >> start) || start != "Time:")
-    {
-        std::cerr << "ERROR! Failed to read start of times\n";
-        return 1;
-    }
-
-    if (!std::getline(infile, numbers))
+    const std::string_view times{*line++};
+    if (!times.starts_with("Time:"))
     {
-        std::cerr << "ERROR! Failed to read times\n";
-        return 1;
+        throw std::runtime_error{"Failed to read start of times"};
     }
 
-    race.time = combineNumberPortions(numbers);
+    race.time = combineNumberPortions(times);
 
     // Read distances
-    if (!(infile >> start) || start != "Distance:")
+    const std::string_view distances{*line};
+    if (!distances.starts_with("Distance:"))
     {
-        std::cerr << "ERROR! Failed to read start of distances\n";
-        return 1;
+        throw std::runtime_error{"Failed to read start of distances"};
     }
 
-    if (!std::getline(infile, numbers))
-    {
-        std::cerr << "ERROR! Failed to read distances\n";
-        return 1;
-    }
+    race.distance = combineNumberPortions(distances);
 
-    race.distance = combineNumberPortions(numbers);
+    aoc::beginPhase("solve");
 
-    std::cout << "Result: " << winMethods(race) << '\n';
+    return toString(winMethods(race));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "utils.h"
@@ -11,23 +12,24 @@ typedef struct
 } Race;
 
 /**
- * @brief Insert a series of time values from infile in the format of "Time: 7 15 30" into races
+ * @brief Insert a series of time values from the next line of reader in the format of "Time: 7 15 30" into races
  *        Only the "time" fields of each race will be set. Distances will all be zero
  * 
- * @param infile 
+ * @param reader 
  * @param races 
  * @return true if read was successful
  */
-static bool readTimes(FILE* const infile, DynamicArray* const races)
+static bool readTimes(LineReader* const reader, DynamicArray* const races)
 {
-    int count = -1;
-    fscanf(infile, "Time: %n", &count);
-
-    if (count == -1)
+    if (!lineReaderNext(reader) || strncmp(reader->line, "Time:", 5) != 0)
         return false;
 
-    for (long long int time; fscanf(infile, "%lld", &time) == 1;)
+    for (char* next = reader->line + 5, * end = NULL;; next = end)
     {
+        const long long int time = strtoll(next, &end, 10);
+        if (end == next)
+            break;
+
         Race race = {.time = time, .distance = 0};
         dynamicArrayPushBack(races, &race, 1);
     }
@@ -36,22 +38,29 @@ static bool readTimes(FILE* const infile, DynamicArray* const races)
 }
 
 /**
- * @brief Read a series of distance values from infile in the format of "Distance: 7 15 30" into races
+ * @brief Read a series of distance values from the next line of reader in the format of "Distance: 7 15 30" into races
  *        Values will be read until either input runs out of distances or races runs out of races
  * 
- * @param infile 
+ * @param reader 
  * @param races 
  * @return true if read was successful
  */
-static bool readDistances(FILE* const infile, DynamicArray* const races)
+static bool readDistances(LineReader* const reader, DynamicArray* const races)
 {
-    int count = -1;
-    fscanf(infile, "Distance: %n", &count);
-
-    if (count == -1)
+    if (!lineReaderNext(reader) || strncmp(reader->line, "Distance:", 9) != 0)
         return false;
 
-    for (size_t i = 0; i < races->size && fscanf(infile, "%lld", &((Race*)dynamicArrayIndex(races, i))->distance) == 1; ++i);
+    char* next = reader->line + 9;
+    for (size_t i = 0; i < races->size; ++i)
+    {
+        char* end = NULL;
+        const long long int distance = strtoll(next, &end, 10);
+        if (end == next)
+            break;
+
+        ((Race*)dynamicArrayIndex(races, i))->distance = distance;
+        next = end;
+    }
 
     return true;
 }
@@ -69,8 +78,13 @@ static DynamicArray readRaces(FILE* const infile)
     DynamicArray races;
     dynamicArrayCreate(&races, sizeof(Race));
 
-    readTimes(infile, &races);
-    readDistances(infile, &races);
+    LineReader reader;
+    lineReaderCreate(&reader, infile);
+
+    readTimes(&reader, &races);
+    readDistances(&reader, &races);
+
+    lineReaderDestroy(&reader);
 
     return races;
 }
@@ -1,23 +1,21 @@
-#include <fstream>
-#include <iostream>
 #include <limits>
+#include <string>
+#include <string_view>
 
-int main()
-{
-    std::ifstream infile{"input.txt"};
+#include "parse.hpp"
+#include "solution.hpp"
 
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Unable to open input file!\n";
-        return -1;
-    }
+namespace
+{
 
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
     int increases{};
 
     int prev{std::numeric_limits<int>::max()};
-    int curr;
 
-    while (infile >> curr)
+    for (const int curr : aoc::parseInts<int>(input))
     {
         if (curr > prev)
             ++increases;
@@ -25,7 +23,9 @@ int main()
         prev = curr;
     }
 
-    std::cout << "Answer: " << increases << '\n';
+    return std::to_string(increases);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,26 +1,24 @@
-#include <fstream>
-#include <iostream>
 #include <limits>
+#include <string>
+#include <string_view>
 
-int main()
-{
-    std::ifstream infile{"input.txt"};
+#include "parse.hpp"
+#include "solution.hpp"
 
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open input file!\n";
-        return -1;
-    }
+namespace
+{
 
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
     int increases{-2};
 
     int prev2{};
     int prev1{};
-    int curr;
 
     int lastSum{std::numeric_limits<int>::max()};
 
-    while (infile >> curr)
+    for (const int curr : aoc::parseInts<int>(input))
     {
         const int sum = curr + prev1 + prev2;
 
@@ -33,7 +31,9 @@ int main()
         lastSum = sum;
     }
 
-    std::cout << "Answer: " << increases << '\n';
+    return std::to_string(increases);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
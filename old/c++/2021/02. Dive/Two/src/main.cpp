@@ -1,19 +1,27 @@
-#include <fstream>
-#include <iostream>
+#include <cstddef>
+#include <string>
+#include <string_view>
 
-int main()
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
 {
-    std::ifstream infile{"input.txt"};
 
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
     int aim{};
     int position{};
     int depth{};
 
-    std::string command;
-    int value;
-
-    while (infile >> command >> value)
+    for (const std::string_view line : aoc::lines(input))
     {
+        // Each line is a command and a value separated by a space
+        const std::size_t spacePos{line.find(' ')};
+        const std::string_view command{line.substr(0, spacePos)};
+        const int value{aoc::parseInt<int>(line.substr(spacePos + 1))};
+
         if (command == "down")
         {
             aim += value;
@@ -29,7 +37,9 @@ int main()
         }
     }
 
-    std::cout << "Answer: " << position * depth << '\n';
+    return std::to_string(position * depth);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
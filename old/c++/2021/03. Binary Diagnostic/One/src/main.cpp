@@ -1,14 +1,20 @@
 #include <array>
 #include <bitset>
-#include <fstream>
-#include <iostream>
+#include <string>
+#include <string_view>
 #include <utility>
 
-int main()
+#include "solution.hpp"
+
+namespace
+{
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
     static constexpr std::size_t SIZE{12};
     
-    std::ifstream infile{"input.txt"};
+    aoc::InputStream infile{input};
 
     std::bitset<SIZE> number;
 
@@ -45,7 +51,9 @@ int main()
             epsilionRate[i] = 0;
     }
 
-    std::cout << gammaRate.to_ullong() * epsilionRate.to_ullong() << '\n';
+    return std::to_string(gammaRate.to_ullong() * epsilionRate.to_ullong());
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -2,20 +2,25 @@
 #include <array>
 #include <bitset>
 #include <cassert>
-#include <fstream>
-#include <iostream>
 #include <iterator>
 #include <limits>
+#include <string>
+#include <string_view>
 #include <vector>
 
+#include "solution.hpp"
+
+namespace
+{
+
 static constexpr std::size_t SIZE{12};
 
 [[nodiscard]]
-static std::vector<std::bitset<SIZE>> loadNumbers()
+static std::vector<std::bitset<SIZE>> loadNumbers(const std::string_view input)
 {
     std::vector<std::bitset<SIZE>> result;
 
-    std::ifstream infile{"input.txt"};
+    aoc::InputStream infile{input};
 
     std::bitset<SIZE> number;
     while (infile >> number)
@@ -26,9 +31,14 @@ static std::vector<std::bitset<SIZE>> loadNumbers()
     return result;
 }
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    const std::vector<std::bitset<SIZE>> numbers{loadNumbers()};
+    aoc::beginPhase("parse");
+
+    const std::vector<std::bitset<SIZE>> numbers{loadNumbers(input)};
+
+    aoc::beginPhase("solve");
 
     std::array<int, SIZE> netOnes{};
 
@@ -99,7 +109,9 @@ int main()
         static_cast<std::size_t>(std::distance(isNumberRemaining.begin(), std::find(isNumberRemaining.begin(), isNumberRemaining.end(), true)))
     };
 
-    std::cout << "Answer: " << numbers[oxygenRatingIndex].to_ullong() * numbers[co2RatingIndex].to_ullong() << '\n';
+    return std::to_string(numbers[oxygenRatingIndex].to_ullong() * numbers[co2RatingIndex].to_ullong());
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
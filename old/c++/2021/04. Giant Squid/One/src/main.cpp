@@ -1,195 +1,446 @@
+#include <algorithm>
 #include <array>
-#include <fstream>
-#include <iostream>
-#include <sstream>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "parse.hpp"
+#include "simd.hpp"
+#include "solution.hpp"
+#include "threads.hpp"
+
+namespace
+{
+
 static constexpr std::size_t SIZE{5};
+static constexpr std::size_t CELLS{SIZE * SIZE};
+
+// Numbers row by row, so cell (x, y) is at y * SIZE + x
+using Board = std::array<int, CELLS>;
 
-struct Tile
+// Called cells of a board are kept as a mask with the bit of each cell at the same position as the cell itself
+static constexpr std::uint32_t ROW_MASK{(1U << SIZE) - 1};
+static constexpr std::uint32_t COLUMN_MASK{[]() -> std::uint32_t
 {
-    int value{};
-    bool called{};
-};
+    std::uint32_t mask{};
+    for (std::size_t y{}; y < SIZE; ++y)
+    {
+        mask |= 1U << (y * SIZE);
+    }
+
+    return mask;
+}()};
 
-class Board
+// Turn of a board that never wins
+static constexpr std::size_t NEVER{std::numeric_limits<std::size_t>::max()};
+
+// Rank of a number that is never called
+static constexpr std::uint32_t NOT_CALLED{std::numeric_limits<std::uint32_t>::max()};
+
+// Calls are ranked in a table indexed by number when every call is below this, and by searching otherwise
+static constexpr std::size_t DENSE_RANK_LIMIT{std::size_t{1} << 20};
+
+// Boards evaluated together by one task of the rank evaluation
+static constexpr std::size_t RANK_CHUNK_SIZE{4096};
+
+[[nodiscard]]
+static std::vector<int> loadNumberList(const std::string_view line)
 {
-public:
-    [[nodiscard]]
-    constexpr int& tile(const std::size_t x, const std::size_t y) noexcept
+    return aoc::parseInts<int>(line);
+}
+
+/**
+ * @brief Read boards of SIZE * SIZE numbers. std::runtime_error will be thrown if the numbers do not fill whole boards
+ *
+ * @param text
+ * @return std::vector<Board>
+ */
+[[nodiscard]]
+static std::vector<Board> loadBoards(const std::string_view text)
+{
+    const std::vector<int> numbers{aoc::parseInts<int>(text)};
+    if (numbers.size() % CELLS != 0)
+        throw std::runtime_error{"Every board must have " + std::to_string(CELLS) + " numbers"};
+
+    std::vector<Board> result(numbers.size() / CELLS);
+    for (std::size_t i{}; i < numbers.size(); ++i)
     {
-        return this->board[y][x].value;
+        result[i / CELLS][i % CELLS] = numbers[i];
     }
 
-    [[nodiscard]]
-    constexpr bool won() const noexcept
+    return result;
+}
+
+/**
+ * @brief Score of board when it wins on turn: the sum of its numbers not called by then times the number called
+ *        std::overflow_error will be thrown if it does not fit in a long long
+ *
+ * @param board
+ * @param calls
+ * @param turn
+ * @return long long int
+ */
+[[nodiscard]]
+static long long int score(const Board& board, const std::vector<int>& calls, const std::size_t turn)
+{
+    const auto calledEnd{calls.begin() + static_cast<std::ptrdiff_t>(turn) + 1};
+
+    // Sums of CELLS ints always fit
+    long long int result{};
+    for (const int number : board)
     {
-        for (std::size_t x{}; x < SIZE; ++x)
-        {
-            bool allCalled{true};
+        if (std::find(calls.begin(), calledEnd, number) == calledEnd)
+            result += number;
+    }
 
-            for (std::size_t y{}; y < SIZE; ++y)
-            {
-                if (!this->board[y][x].called)
-                {
-                    allCalled = false;
-                    break;
-                }
-            }
+    if (__builtin_mul_overflow(result, calls[turn], &result))
+        throw std::overflow_error{"Score does not fit in a long long"};
 
-            if (allCalled)
-                return true;
-        }
+    return result;
+}
+
+/**
+ * @brief Turn each number is first called on, however large the numbers are
+ *        Calls that are all small enough are kept as a table indexed by number. Otherwise the distinct calls are kept
+ *        sorted and searched, so memory only ever grows with the number of calls
+ *
+ */
+class CallRanks
+{
+public:
+    /**
+     * @brief Rank calls. std::runtime_error will be thrown if there are too many of them to rank
+     *
+     * @param calls
+     */
+    explicit CallRanks(const std::vector<int>& calls)
+    {
+        if (calls.size() >= NOT_CALLED)
+            throw std::runtime_error{"Too many calls to rank"};
+        if (calls.empty())
+            return;
 
-        for (std::size_t y{}; y < SIZE; ++y)
+        const auto[low, high]{std::ranges::minmax(calls)};
+        if (low >= 0 && static_cast<std::size_t>(high) < DENSE_RANK_LIMIT)
         {
-            bool allCalled{true};
+            this->table.assign(static_cast<std::size_t>(high) + 1, NOT_CALLED);
 
-            for (std::size_t x{}; x < SIZE; ++x)
+            // Backwards, so the first call of a number is the one kept
+            for (std::size_t turn{calls.size()}; turn > 0; --turn)
             {
-                if (!this->board[y][x].called)
-                {
-                    allCalled = false;
-                    break;
-                }
+                this->table[static_cast<std::size_t>(calls[turn - 1])] = static_cast<std::uint32_t>(turn - 1);
             }
 
-            if (allCalled)
-                return true;
+            return;
         }
 
-        return false;
+        for (std::size_t turn{}; turn < calls.size(); ++turn)
+        {
+            this->sorted.push_back({calls[turn], static_cast<std::uint32_t>(turn)});
+        }
+
+        // Stable, so the first call of a number comes first and is the one kept
+        std::ranges::stable_sort(this->sorted, {}, &Call::number);
+        const auto repeats{std::ranges::unique(this->sorted, {}, &Call::number)};
+        this->sorted.erase(repeats.begin(), repeats.end());
     }
 
-    constexpr void call(const int number) noexcept
+    /**
+     * @brief Turn number is first called on
+     *
+     * @param number
+     * @return std::uint32_t NOT_CALLED if it never is
+     */
+    [[nodiscard]]
+    std::uint32_t operator()(const int number) const noexcept
     {
-        for (std::size_t y{}; y < SIZE; ++y)
+        if (!this->table.empty())
         {
-            for (std::size_t x{}; x < SIZE; ++x)
-            {
-                if (this->board[y][x].value == number)
-                    this->board[y][x].called = true;
-            }
+            if (number < 0 || static_cast<std::size_t>(number) >= this->table.size())
+                return NOT_CALLED;
+
+            return this->table[static_cast<std::size_t>(number)];
         }
+
+        const auto call{std::ranges::lower_bound(this->sorted, number, {}, &Call::number)};
+        return call != this->sorted.end() && call->number == number ? call->rank : NOT_CALLED;
     }
+private:
+    struct Call
+    {
+        int number{};
+        std::uint32_t rank{};
+    };
 
-    [[nodiscard]]
-    int uncalledNumberSum() const
+    // Rank of every number up to the largest call, when the calls are small enough for it
+    std::vector<std::uint32_t> table;
+
+    // Otherwise the first call of each number, by number
+    std::vector<Call> sorted;
+};
+
+/**
+ * @brief Play every board at once and find the turn each of them wins on, in one pass over the called numbers
+ *        A reverse index from each call to the cells holding its number means a call only touches boards with that
+ *        number, and only the row and column of the called cell need checking for a win
+ *
+ * @param calls
+ * @param boards
+ * @return std::vector<std::size_t> Index of the call each board wins on, or NEVER
+ */
+[[nodiscard]]
+static std::vector<std::size_t> indexedWinTurns(const std::vector<int>& calls, const std::vector<Board>& boards)
+{
+    const CallRanks ranks{calls};
+
+    // Turn each cell's number is first called on, found once as the lookup may be a search
+    std::vector<std::uint32_t> cellRanks(boards.size() * CELLS);
+    for (std::size_t i{}; i < cellRanks.size(); ++i)
+    {
+        cellRanks[i] = ranks(boards[i / CELLS][i % CELLS]);
+    }
+
+    // Cells holding each number, stored as board * CELLS + cell and grouped by the turn the number is first called on
+    // Cells called first on turn t are cells[starts[t]] up to cells[starts[t + 1]], and cells never called are left out
+    std::vector<std::size_t> starts(calls.size() + 1);
+    for (const std::uint32_t rank : cellRanks)
+    {
+        if (rank != NOT_CALLED)
+            ++starts[rank + 1];
+    }
+
+    for (std::size_t i{1}; i < starts.size(); ++i)
+    {
+        starts[i] += starts[i - 1];
+    }
+
+    std::vector<std::uint32_t> cells(starts.back());
+    std::vector<std::size_t> next(starts.begin(), starts.end() - 1);
+    for (std::size_t i{}; i < cellRanks.size(); ++i)
     {
-        int result{};
+        if (cellRanks[i] != NOT_CALLED)
+            cells[next[cellRanks[i]]++] = static_cast<std::uint32_t>(i);
+    }
+
+    std::vector<std::uint32_t> called(boards.size());
+    std::vector<std::size_t> turns(boards.size(), NEVER);
+    std::size_t playing{boards.size()};
 
-        for (std::size_t y{}; y < SIZE; ++y)
+    // Repeated calls of a number have no cells of their own, as nothing changes when they are called
+    for (std::size_t turn{}; turn < calls.size() && playing > 0; ++turn)
+    {
+        for (std::size_t i{starts[turn]}; i < starts[turn + 1]; ++i)
         {
-            for (std::size_t x{}; x < SIZE; ++x)
+            const std::size_t board{cells[i] / CELLS};
+            const std::size_t cell{cells[i] % CELLS};
+
+            // Boards stop playing once they win
+            if (turns[board] != NEVER)
+                continue;
+
+            std::uint32_t& mask{called[board]};
+            mask |= 1U << cell;
+
+            const std::uint32_t row{ROW_MASK << (cell / SIZE * SIZE)};
+            const std::uint32_t column{COLUMN_MASK << (cell % SIZE)};
+
+            if ((mask & row) == row || (mask & column) == column)
             {
-                if (!this->board[y][x].called)
-                    result += this->board[y][x].value;
+                turns[board] = turn;
+                --playing;
             }
         }
+    }
 
-        return result;
+    return turns;
+}
+
+/**
+ * @brief Turn board wins on from the turn each of its numbers is called on
+ *        A line is complete once its last number is called, and the board wins with its first complete line
+ *
+ * @param board
+ * @param ranks
+ * @return std::uint32_t Turn, or NOT_CALLED if it never wins
+ */
+[[nodiscard]]
+static std::uint32_t rankedWinTurn(const Board& board, const CallRanks& ranks) noexcept
+{
+    std::array<std::uint32_t, CELLS> cellRanks;
+    for (std::size_t cell{}; cell < CELLS; ++cell)
+    {
+        cellRanks[cell] = ranks(board[cell]);
     }
 
-    void print() const
+    std::uint32_t result{NOT_CALLED};
+    for (std::size_t i{}; i < SIZE; ++i)
     {
-        for (std::size_t y{}; y < SIZE; ++y)
+        std::uint32_t rowDone{0};
+        std::uint32_t columnDone{0};
+        for (std::size_t j{}; j < SIZE; ++j)
         {
-            for (std::size_t x{}; x < SIZE; ++x)
-            {
-                std::cout << this->board[y][x].value << ' ';
-            }
-            std::cout << '\n';
+            rowDone = std::max(rowDone, cellRanks[i * SIZE + j]);
+            columnDone = std::max(columnDone, cellRanks[j * SIZE + i]);
         }
 
-        std::cout << '\n';
+        result = std::min({result, rowDone, columnDone});
     }
-private:
-    std::array<std::array<Tile, SIZE>, SIZE> board{};
-};
 
-[[nodiscard]]
-static std::vector<int> loadNumberList(std::ifstream& infile)
-{
-    std::vector<int> result;
+    return result;
+}
 
-    std::string line;
-    std::getline(infile, line);
+#ifdef AOC_SIMD_X86
+/**
+ * @brief rankedWinTurn for 8 boards at once, one per lane. The ranks of each cell are laid out side by side for all 8
+ *        boards, so lines reduce with plain vertical max and min instead of shuffling within a board
+ *
+ * @param boards First of the 8 boards
+ * @param ranks
+ * @param turns Where the 8 turns are written
+ */
+[[gnu::target("avx2")]]
+static void rankedWinTurnsAvx2(const Board* const boards, const CallRanks& ranks, std::uint32_t* const turns) noexcept
+{
+    // Table lookups are left scalar, as gathers are no faster on many CPUs
+    alignas(32) std::uint32_t cellRanks[CELLS][8];
+    for (std::size_t board{}; board < 8; ++board)
+    {
+        for (std::size_t cell{}; cell < CELLS; ++cell)
+        {
+            cellRanks[cell][board] = ranks(boards[board][cell]);
+        }
+    }
 
-    std::stringstream ss{line};
+    __m256i lanes[CELLS];
+    for (std::size_t cell{}; cell < CELLS; ++cell)
+    {
+        lanes[cell] = _mm256_load_si256(reinterpret_cast<const __m256i*>(cellRanks[cell]));
+    }
 
-    while (std::getline(ss, line, ','))
+    __m256i result{_mm256_set1_epi32(-1)};
+    for (std::size_t i{}; i < SIZE; ++i)
     {
-        result.push_back(std::stoi(line));
+        __m256i rowDone{lanes[i * SIZE]};
+        __m256i columnDone{lanes[i]};
+        for (std::size_t j{1}; j < SIZE; ++j)
+        {
+            rowDone = _mm256_max_epu32(rowDone, lanes[i * SIZE + j]);
+            columnDone = _mm256_max_epu32(columnDone, lanes[j * SIZE + i]);
+        }
+
+        result = _mm256_min_epu32(result, _mm256_min_epu32(rowDone, columnDone));
     }
 
-    return result;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(turns), result);
 }
-
+#endif
+
+/**
+ * @brief Same as indexedWinTurns, but with no simulation at all. Calls are turned into a table of the turn each
+ *        number is called on, and the win turn of each board is the earliest of the turns its lines are completed
+ *        Boards are independent, so they are split into chunks evaluated in parallel on pool
+ *
+ * @param calls
+ * @param boards
+ * @param pool
+ * @return std::vector<std::size_t> Index of the call each board wins on, or NEVER
+ */
 [[nodiscard]]
-static std::vector<Board> loadBoards(std::ifstream& infile)
+static std::vector<std::size_t> rankedWinTurns(const std::vector<int>& calls, const std::vector<Board>& boards,
+    aoc::ThreadPool& pool)
 {
-    std::vector<Board> result;
-
-    int number;
-    Board* board{&result.emplace_back()};
-    std::size_t x{};
-    std::size_t y{};
+    const CallRanks ranks{calls};
+    std::vector<std::uint32_t> rankTurns(boards.size());
 
-    while (infile >> number)
+    const std::size_t chunkCount{(boards.size() + RANK_CHUNK_SIZE - 1) / RANK_CHUNK_SIZE};
+    pool.parallelFor(chunkCount, [&boards, &ranks, &rankTurns](const std::size_t chunk) -> void
     {
-        board->tile(x++, y) = number;
+        std::size_t board{chunk * RANK_CHUNK_SIZE};
+        const std::size_t last{std::min(board + RANK_CHUNK_SIZE, boards.size())};
 
-        if (x >= SIZE)
+#ifdef AOC_SIMD_X86
+        if (aoc::simd::level() == aoc::simd::Level::AVX2)
         {
-            x = 0;
-            ++y;
+            for (; last - board >= 8; board += 8)
+            {
+                rankedWinTurnsAvx2(&boards[board], ranks, &rankTurns[board]);
+            }
         }
-        
-        if (y >= SIZE)
+#endif
+
+        for (; board < last; ++board)
         {
-            y = 0;
-            board = &result.emplace_back();
+            rankTurns[board] = rankedWinTurn(boards[board], ranks);
         }
+    });
+
+    std::vector<std::size_t> turns(boards.size());
+    for (std::size_t board{}; board < boards.size(); ++board)
+    {
+        turns[board] = rankTurns[board] == NOT_CALLED ? NEVER : rankTurns[board];
     }
 
-    return result;
+    return turns;
+}
+
+/**
+ * @brief Turn every board wins on, evaluated the way the AOC_BINGO environment variable names: "index" to play the
+ *        calls through a reverse index, or "rank" to evaluate boards from a table of call turns in parallel
+ *        Ranking is used when it is not set. std::runtime_error will be thrown for any other name
+ *
+ * @param calls
+ * @param boards
+ * @return std::vector<std::size_t> Index of the call each board wins on, or NEVER
+ */
+[[nodiscard]]
+static std::vector<std::size_t> winTurns(const std::vector<int>& calls, const std::vector<Board>& boards)
+{
+    const char* const requested{std::getenv("AOC_BINGO")};
+    const std::string_view evaluation{requested == nullptr ? "rank" : requested};
+
+    if (evaluation == "index")
+        return indexedWinTurns(calls, boards);
+    if (evaluation == "rank")
+        return rankedWinTurns(calls, boards, aoc::threadPool());
+
+    throw std::runtime_error{"Unknown evaluation \"" + std::string{evaluation} + "\", expected index or rank"};
 }
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
+    aoc::beginPhase("parse");
 
-    const std::vector<int> numberList{loadNumberList(infile)};
+    // The boards are everything after the first line
+    const std::string_view numberLine{*aoc::lines(input).begin()};
+    const std::vector<int> numberList{loadNumberList(numberLine)};
 
-    std::vector<Board> boards{loadBoards(infile)};
+    const std::vector<Board> boards{loadBoards(input.substr(numberLine.size()))};
 
-    const Board* winningBoard{nullptr};
-    int winningNumber;
+    aoc::beginPhase("solve");
 
-    for (std::size_t i{}; i < numberList.size() && winningBoard == nullptr; ++i)
-    {
-        const int number{numberList[i]};
+    const std::vector<std::size_t> turns{winTurns(numberList, boards)};
 
-        for (Board& board : boards)
-        {
-            board.call(number);
+    // First board to win. Of boards that win on the same call, the first one in the input counts
+    std::size_t firstWinner{NEVER};
 
-            if (board.won())
-            {
-                winningBoard = &board;
-                winningNumber = number;
-                break;
-            }
-        }
+    for (std::size_t board{}; board < boards.size(); ++board)
+    {
+        if (turns[board] != NEVER && (firstWinner == NEVER || turns[board] < turns[firstWinner]))
+            firstWinner = board;
     }
 
-    // for (const Board& board : boards)
-    // {
-    //     board.print();
-    // }
+    if (firstWinner == NEVER)
+        throw std::runtime_error{"No board ever wins"};
 
-    std::cout << "Answer: " << winningBoard->uncalledNumberSum() * winningNumber << '\n';
+    return std::to_string(score(boards[firstWinner], numberList, turns[firstWinner]));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
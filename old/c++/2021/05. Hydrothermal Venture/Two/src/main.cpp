@@ -1,84 +1,796 @@
 #include <algorithm>
-#include <cassert>
-#include <fstream>
-#include <iostream>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
-struct Point
+#include "grid.hpp"
+#include "parse.hpp"
+#include "simd.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
+// Lines needed over a point for it to count. Counters saturate here, so a byte per point is enough
+static constexpr std::uint8_t OVERLAP{2};
+
+// Bounding boxes with more points than this are drawn into sparse tiles instead of one dense raster
+static constexpr long long int DENSE_CELL_LIMIT{1LL << 26};
+
+// Sparse tiles are TILE_SIZE * TILE_SIZE points
+static constexpr int TILE_SHIFT{6};
+static constexpr int TILE_SIZE{1 << TILE_SHIFT};
+
+// Lines are split into families of parallel lines: horizontal, vertical, diagonal going right and diagonal going left
+static constexpr std::size_t FAMILY_COUNT{4};
+static constexpr std::size_t HORIZONTAL{0};
+
+// How far x moves for each step down a line of each family. Horizontal lines never step down
+static constexpr std::array<long long int, FAMILY_COUNT> FAMILY_DX{0, 0, 1, -1};
+
+// Wide enough to hold the distance between any two ints
+using Coordinate = long long int;
+
+/**
+ * @brief Run of count points from (x, y), each one (dx, dy) from the previous one
+ *        Lines are stored so they go right when horizontal and down otherwise
+ *
+ */
+struct Line
+{
+    Coordinate x{};
+    Coordinate y{};
+    Coordinate dx{};
+    Coordinate dy{};
+    Coordinate count{};
+};
+
+/**
+ * @brief Read lines as "x1,y1 -> x2,y2". Diagonal lines must be at 45 degrees, or std::runtime_error will be thrown
+ *
+ * @param input
+ * @return std::vector<Line>
+ */
+[[nodiscard]]
+static std::vector<Line> loadLines(const std::string_view input)
+{
+    const std::vector<int> coordinates{aoc::parseInts<int>(input)};
+    if (coordinates.size() % 4 != 0)
+        throw std::runtime_error{"Every line must be \"x1,y1 -> x2,y2\""};
+
+    std::vector<Line> result;
+    result.reserve(coordinates.size() / 4);
+
+    for (std::size_t i{0}; i < coordinates.size(); i += 4)
+    {
+        Coordinate x1{coordinates[i]};
+        Coordinate y1{coordinates[i + 1]};
+
+        Coordinate x2{coordinates[i + 2]};
+        Coordinate y2{coordinates[i + 3]};
+
+        if (y1 == y2)
+        {
+            result.push_back({std::min(x1, x2), y1, 1, 0, std::abs(x2 - x1) + 1});
+            continue;
+        }
+
+        if (y1 > y2)
+        {
+            std::swap(x1, x2);
+            std::swap(y1, y2);
+        }
+
+        if (x1 != x2 && std::abs(x2 - x1) != y2 - y1)
+            throw std::runtime_error{"Diagonal lines must be at 45 degrees"};
+
+        result.push_back({x1, y1, x1 < x2 ? 1 : x1 > x2 ? -1 : 0, 1, y2 - y1 + 1});
+    }
+
+    return result;
+}
+
+static void increment(std::uint8_t& counter) noexcept
+{
+    if (counter < OVERLAP)
+        ++counter;
+}
+
+#ifdef AOC_SIMD_X86
+// Both kernels increment whole blocks from position on and return where the first partial block starts
+
+[[gnu::target("sse2")]]
+static std::size_t incrementSse2(const std::span<std::uint8_t> counters, std::size_t position) noexcept
+{
+    const __m128i one{_mm_set1_epi8(1)};
+    const __m128i overlap{_mm_set1_epi8(static_cast<char>(OVERLAP))};
+
+    for (; counters.size() - position >= 16; position += 16)
+    {
+        __m128i* const block{reinterpret_cast<__m128i*>(counters.data() + position)};
+        _mm_storeu_si128(block, _mm_min_epu8(_mm_add_epi8(_mm_loadu_si128(block), one), overlap));
+    }
+
+    return position;
+}
+
+[[gnu::target("avx2")]]
+static std::size_t incrementAvx2(const std::span<std::uint8_t> counters) noexcept
+{
+    const __m256i one{_mm256_set1_epi8(1)};
+    const __m256i overlap{_mm256_set1_epi8(static_cast<char>(OVERLAP))};
+
+    std::size_t position{};
+    for (; counters.size() - position >= 32; position += 32)
+    {
+        __m256i* const block{reinterpret_cast<__m256i*>(counters.data() + position)};
+        _mm256_storeu_si256(block, _mm256_min_epu8(_mm256_add_epi8(_mm256_loadu_si256(block), one), overlap));
+    }
+
+    return incrementSse2(counters, position);
+}
+
+// Both kernels count the saturated counters of whole blocks from position on, and return where the first partial block
+// starts
+
+[[gnu::target("sse2")]]
+static std::size_t countSse2(const std::span<const std::uint8_t> counters, std::size_t position, std::size_t& count)
+    noexcept
+{
+    const __m128i overlap{_mm_set1_epi8(static_cast<char>(OVERLAP))};
+
+    for (; counters.size() - position >= 16; position += 16)
+    {
+        const __m128i block{_mm_loadu_si128(reinterpret_cast<const __m128i*>(counters.data() + position))};
+        count += static_cast<std::size_t>(
+            std::popcount(static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, overlap)))));
+    }
+
+    return position;
+}
+
+[[gnu::target("avx2")]]
+static std::size_t countAvx2(const std::span<const std::uint8_t> counters, std::size_t& count) noexcept
+{
+    const __m256i overlap{_mm256_set1_epi8(static_cast<char>(OVERLAP))};
+
+    std::size_t position{};
+    for (; counters.size() - position >= 32; position += 32)
+    {
+        const __m256i block{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(counters.data() + position))};
+        count += static_cast<std::size_t>(
+            std::popcount(static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, overlap)))));
+    }
+
+    return countSse2(counters, position, count);
+}
+#endif
+
+/**
+ * @brief Increment every counter of a horizontal run
+ *
+ * @param counters
+ */
+static void incrementRun(const std::span<std::uint8_t> counters) noexcept
+{
+    std::size_t position{};
+
+#ifdef AOC_SIMD_X86
+    switch (aoc::simd::level())
+    {
+    case aoc::simd::Level::AVX2:
+        position = incrementAvx2(counters);
+        break;
+    case aoc::simd::Level::SSE2:
+        position = incrementSse2(counters, 0);
+        break;
+    case aoc::simd::Level::Scalar:
+        break;
+    }
+#endif
+
+    for (; position < counters.size(); ++position)
+    {
+        increment(counters[position]);
+    }
+}
+
+/**
+ * @brief Number of counters that reached OVERLAP
+ *
+ * @param counters
+ * @return std::size_t
+ */
+[[nodiscard]]
+static std::size_t countOverlaps(const std::span<const std::uint8_t> counters) noexcept
+{
+    std::size_t count{};
+    std::size_t position{};
+
+#ifdef AOC_SIMD_X86
+    switch (aoc::simd::level())
+    {
+    case aoc::simd::Level::AVX2:
+        position = countAvx2(counters, count);
+        break;
+    case aoc::simd::Level::SSE2:
+        position = countSse2(counters, 0, count);
+        break;
+    case aoc::simd::Level::Scalar:
+        break;
+    }
+#endif
+
+    for (; position < counters.size(); ++position)
+    {
+        if (counters[position] == OVERLAP)
+            ++count;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Smallest box holding every point of every line
+ *
+ */
+struct Bounds
+{
+    Coordinate minX{};
+    Coordinate minY{};
+    Coordinate maxX{};
+    Coordinate maxY{};
+
+    /**
+     * @brief Whether the box has at most limit points. Boxes between far apart ints have too many to count in a long
+     *        long
+     *
+     * @param limit
+     * @return bool
+     */
+    [[nodiscard]]
+    bool holdsAtMost(const long long int limit) const noexcept
+    {
+        const Coordinate width{this->maxX - this->minX + 1};
+        const Coordinate height{this->maxY - this->minY + 1};
+
+        return width <= limit / height;
+    }
+};
+
+/**
+ * @brief Bounds of lines, which must not be empty
+ *
+ * @param lines
+ * @return Bounds
+ */
+[[nodiscard]]
+static Bounds boundsOf(const std::vector<Line>& lines) noexcept
+{
+    Bounds result{lines.front().x, lines.front().y, lines.front().x, lines.front().y};
+
+    for (const Line& line : lines)
+    {
+        const Coordinate lastX{line.x + line.dx * (line.count - 1)};
+        const Coordinate lastY{line.y + line.dy * (line.count - 1)};
+
+        result.minX = std::min({result.minX, line.x, lastX});
+        result.minY = std::min(result.minY, line.y);
+        result.maxX = std::max({result.maxX, line.x, lastX});
+        result.maxY = std::max(result.maxY, lastY);
+    }
+
+    return result;
+}
+
+/**
+ * @brief One counter for every point of the bounding box of the lines. Horizontal lines are vectorized runs along a
+ *        row, and every other line steps through the raster a row at a time
+ *
+ */
+class DenseRaster
+{
+public:
+    explicit DenseRaster(const Bounds& bounds) :
+        counters(static_cast<std::size_t>(bounds.maxX - bounds.minX + 1),
+            static_cast<std::size_t>(bounds.maxY - bounds.minY + 1)),
+        minX{bounds.minX}, minY{bounds.minY} {}
+
+    void draw(const Line& line) noexcept
+    {
+        const std::size_t x{static_cast<std::size_t>(line.x - this->minX)};
+        const std::size_t y{static_cast<std::size_t>(line.y - this->minY)};
+        const std::size_t count{static_cast<std::size_t>(line.count)};
+
+        if (line.dy == 0)
+        {
+            incrementRun(this->counters.row(y).subspan(x, count));
+            return;
+        }
+
+        // Relies on wraparound for lines going left
+        const std::size_t step{this->counters.stride() + static_cast<std::size_t>(line.dx)};
+
+        std::size_t position{this->counters.index(x, y)};
+        for (std::size_t i{}; i < count; ++i, position += step)
+        {
+            increment(this->counters[position]);
+        }
+    }
+
+    [[nodiscard]]
+    std::size_t overlapCount() const noexcept
+    {
+        return countOverlaps(this->counters.cellsWithBorder());
+    }
+private:
+    aoc::Grid<std::uint8_t> counters;
+
+    // Point the top left counter is for
+    Coordinate minX;
+    Coordinate minY;
+};
+
+/**
+ * @brief Counters for the tiles lines pass through only, for lines spread too far apart to give every point a counter
+ *
+ */
+class SparseRaster
 {
-    int x{};
-    int y{};
+public:
+    void draw(const Line& line)
+    {
+        if (line.dy == 0)
+        {
+            // Split into the runs that fall in each tile
+            const Coordinate y{line.y & (TILE_SIZE - 1)};
+            for (Coordinate x{line.x}, remaining{line.count}; remaining > 0;)
+            {
+                const Coordinate tileX{x & (TILE_SIZE - 1)};
+                const Coordinate count{std::min(remaining, TILE_SIZE - tileX)};
+
+                Tile& tile{this->tile(x >> TILE_SHIFT, line.y >> TILE_SHIFT)};
+                incrementRun(std::span{tile}.subspan(static_cast<std::size_t>(y * TILE_SIZE + tileX),
+                    static_cast<std::size_t>(count)));
+
+                x += count;
+                remaining -= count;
+            }
+
+            return;
+        }
+
+        Coordinate x{line.x};
+        Coordinate y{line.y};
+        for (Coordinate i{}; i < line.count; ++i, x += line.dx, y += line.dy)
+        {
+            Tile& tile{this->tile(x >> TILE_SHIFT, y >> TILE_SHIFT)};
+            increment(tile[static_cast<std::size_t>((y & (TILE_SIZE - 1)) * TILE_SIZE + (x & (TILE_SIZE - 1)))]);
+        }
+    }
+
+    [[nodiscard]]
+    std::size_t overlapCount() const noexcept
+    {
+        std::size_t result{};
+        for (const auto&[key, tile] : this->tiles)
+        {
+            result += countOverlaps(tile);
+        }
+
+        return result;
+    }
+private:
+    using Tile = std::array<std::uint8_t, TILE_SIZE * TILE_SIZE>;
+
+    std::unordered_map<std::uint64_t, Tile> tiles;
+
+    // Most points are in the same tile as the one before
+    std::uint64_t lastKey{};
+    Tile* lastTile{nullptr};
 
-    bool operator==(const Point& rhs) const = default;
+    /**
+     * @brief Tile at (tileX, tileY) in tiles, created with every counter at 0 the first time it is used
+     *
+     * @param tileX
+     * @param tileY
+     * @return Tile&
+     */
+    [[nodiscard]]
+    Tile& tile(const Coordinate tileX, const Coordinate tileY)
+    {
+        const std::uint64_t key{static_cast<std::uint64_t>(static_cast<std::uint32_t>(tileX)) << 32 |
+            static_cast<std::uint32_t>(tileY)};
+
+        if (this->lastTile == nullptr || key != this->lastKey)
+        {
+            this->lastKey = key;
+            this->lastTile = &this->tiles.try_emplace(key).first->second;
+        }
+
+        return *this->lastTile;
+    }
 };
 
-template<>
-struct std::hash<Point>
+/**
+ * @brief Draw every line into raster and count the points where at least OVERLAP of them cross
+ *
+ * @param raster
+ * @param lines
+ * @return std::size_t
+ */
+template <typename Raster>
+[[nodiscard]]
+static std::size_t drawnOverlapCount(Raster&& raster, const std::vector<Line>& lines)
 {
-    std::size_t operator()(const Point& point) const noexcept
+    for (const Line& line : lines)
     {
-        const std::size_t h1{std::hash<int>{}(point.x)};
-        const std::size_t h2{std::hash<int>{}(point.y)};
-        return h1 ^ (h2 << 1);
+        raster.draw(line);
     }
+
+    return raster.overlapCount();
+}
+
+struct Point
+{
+    Coordinate x{};
+    Coordinate y{};
+
+    auto operator<=>(const Point& rhs) const = default;
 };
 
-int main()
+/**
+ * @brief Points first to last along one line of a family. Every point of a line shares the same key
+ *
+ */
+struct Span
+{
+    Coordinate key{};
+    Coordinate first{};
+    Coordinate last{};
+
+    auto operator<=>(const Span& rhs) const = default;
+};
+
+[[nodiscard]]
+static std::size_t familyOf(const Line& line) noexcept
+{
+    if (line.dy == 0)
+        return HORIZONTAL;
+
+    return line.dx == 0 ? 1 : line.dx == 1 ? 2 : 3;
+}
+
+/**
+ * @brief Key of the line of family that point is on
+ *
+ * @param family
+ * @param point
+ * @return Coordinate
+ */
+[[nodiscard]]
+static Coordinate keyOf(const std::size_t family, const Point& point) noexcept
+{
+    return family == HORIZONTAL ? point.y : point.x - FAMILY_DX[family] * point.y;
+}
+
+/**
+ * @brief Position of point along its line of family
+ *
+ * @param family
+ * @param point
+ * @return Coordinate
+ */
+[[nodiscard]]
+static Coordinate positionOf(const std::size_t family, const Point& point) noexcept
+{
+    return family == HORIZONTAL ? point.x : point.y;
+}
+
+[[nodiscard]]
+static Point pointOf(const std::size_t family, const Coordinate key, const Coordinate position) noexcept
 {
-    using namespace std::string_literals;
+    return family == HORIZONTAL ? Point{position, key} : Point{key + FAMILY_DX[family] * position, position};
+}
 
-    std::ifstream infile{"input.txt"};
+/**
+ * @brief Point where the line of family first with firstKey crosses the line of family second with secondKey
+ *        Diagonals of different directions can cross between points, and then there is none. The families must differ
+ *
+ * @param first
+ * @param firstKey
+ * @param second
+ * @param secondKey
+ * @return std::optional<Point>
+ */
+[[nodiscard]]
+static std::optional<Point> crossing(const std::size_t first, const Coordinate firstKey, const std::size_t second,
+    const Coordinate secondKey) noexcept
+{
+    if (first == HORIZONTAL)
+        return pointOf(second, secondKey, firstKey);
+    if (second == HORIZONTAL)
+        return pointOf(first, firstKey, secondKey);
 
-    std::unordered_map<Point, int> counts;
+    // firstKey + first dx * y == secondKey + second dx * y
+    const Coordinate slope{FAMILY_DX[second] - FAMILY_DX[first]};
+    if ((firstKey - secondKey) % slope != 0)
+        return std::nullopt;
+
+    return pointOf(first, firstKey, (firstKey - secondKey) / slope);
+}
+
+/**
+ * @brief Add span to the end of runs sorted by key and then by first, merging it into the last run if they touch
+ *
+ * @param runs
+ * @param span Must not sort before the last run
+ */
+static void append(std::vector<Span>& runs, const Span& span)
+{
+    if (!runs.empty() && runs.back().key == span.key && span.first <= runs.back().last + 1)
+        runs.back().last = std::max(runs.back().last, span.last);
+    else
+        runs.push_back(span);
+}
+
+/**
+ * @brief Whether point is in one of runs of family
+ *
+ * @param runs Sorted and merged by append
+ * @param family
+ * @param point
+ * @return bool
+ */
+[[nodiscard]]
+static bool contains(const std::vector<Span>& runs, const std::size_t family, const Point& point) noexcept
+{
+    const Span probe{keyOf(family, point), positionOf(family, point), std::numeric_limits<Coordinate>::max()};
+
+    // Last run starting at or before the point
+    const auto run{std::ranges::upper_bound(runs, probe)};
+    return run != runs.begin() && std::prev(run)->key == probe.key && std::prev(run)->last >= probe.first;
+}
+
+/**
+ * @brief Points covered by the lines of one family, as sorted and merged runs
+ *
+ */
+struct Coverage
+{
+    // Covered by any line
+    std::vector<Span> covered;
+    // Covered by more than one line
+    std::vector<Span> overlapping;
+};
 
-    std::string line;
-    while (std::getline(infile, line))
+[[nodiscard]]
+static Coverage coverageOf(std::vector<Span> spans)
+{
+    std::ranges::sort(spans);
+
+    Coverage result;
+    for (const Span& span : spans)
+    {
+        // Runs are built in order of first, so whatever span shares with the last run was already covered
+        if (!result.covered.empty() && result.covered.back().key == span.key && span.first <= result.covered.back().last)
+            append(result.overlapping, {span.key, span.first, std::min(span.last, result.covered.back().last)});
+
+        append(result.covered, span);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Add every point where a run of family first crosses a run of family second to result
+ *        Measured by the keys of second across and the keys of first down, runs of first are horizontal and runs of
+ *        second are vertical, so they are found by sweeping across with the set of horizontal runs crossed so far
+ *        Diagonals of different directions only meet at a point when their keys have the same parity, so their runs
+ *        are kept in a set for each parity and a column only searches the one it can cross
+ *
+ * @param first
+ * @param firstRuns
+ * @param second
+ * @param secondRuns
+ * @param result
+ */
+static void addCrossings(const std::size_t first, const std::vector<Span>& firstRuns, const std::size_t second,
+    const std::vector<Span>& secondRuns, std::vector<Point>& result)
+{
+    enum class Kind
+    {
+        // Ordered so runs that end before a column are gone, and runs that start at it are there, when it is checked
+        End,
+        Start,
+        Column
+    };
+
+    struct Event
+    {
+        Coordinate across{};
+        Kind kind{};
+        Coordinate down{};
+        Coordinate downLast{};
+
+        auto operator<=>(const Event& rhs) const = default;
+    };
+
+    std::vector<Event> events;
+    events.reserve(firstRuns.size() * 2 + secondRuns.size());
+
+    for (const Span& run : firstRuns)
     {
-        const std::size_t comma1Pos{line.find(',')};
-        const std::size_t comma2Pos{line.find_last_of(',')};
-        const std::size_t firstSpacePos{line.find(' ')};
-        const std::size_t lastSpacePos{line.find('>') + 1};
+        const Coordinate from{keyOf(second, pointOf(first, run.key, run.first))};
+        const Coordinate to{keyOf(second, pointOf(first, run.key, run.last))};
 
-        const int x1{std::stoi(line.substr(0, comma1Pos))};
-        const int y1{std::stoi(line.substr(comma1Pos + 1, firstSpacePos - comma1Pos + 1))};
+        events.push_back({std::min(from, to), Kind::Start, run.key, run.key});
+        events.push_back({std::max(from, to) + 1, Kind::End, run.key, run.key});
+    }
 
-        const int x2{std::stoi(line.substr(lastSpacePos + 1, comma2Pos - (lastSpacePos + 1)))};
-        const int y2{std::stoi(line.substr(comma2Pos + 1))};
+    for (const Span& run : secondRuns)
+    {
+        const Coordinate from{keyOf(first, pointOf(second, run.key, run.first))};
+        const Coordinate to{keyOf(first, pointOf(second, run.key, run.last))};
 
-        int x{x1};
-        int y{y1};
+        events.push_back({run.key, Kind::Column, std::min(from, to), std::max(from, to)});
+    }
+
+    std::ranges::sort(events);
+
+    // Lines cross at a point only when the difference of their keys is a multiple of the difference of their slopes
+    const bool byParity{first != HORIZONTAL && (FAMILY_DX[second] - FAMILY_DX[first]) % 2 == 0};
+    const auto parityOf{[byParity](const Coordinate key) -> std::size_t
+    {
+        return byParity ? static_cast<std::size_t>(key & 1) : 0;
+    }};
 
-        ++counts[{x, y}];
+    // Runs of one line never overlap, so there is at most one run of each key at a time
+    std::array<std::set<Coordinate>, 2> crossed;
 
-        do
+    for (const Event& event : events)
+    {
+        switch (event.kind)
+        {
+        case Kind::End:
+            crossed[parityOf(event.down)].erase(event.down);
+            break;
+        case Kind::Start:
+            crossed[parityOf(event.down)].insert(event.down);
+            break;
+        case Kind::Column:
         {
-            if (x < x2)
-                ++x;
-            else if (x > x2)
-                --x;
+            // Every key searched is a crossing
+            const std::set<Coordinate>& keys{crossed[parityOf(event.across)]};
+            for (auto key{keys.lower_bound(event.down)}; key != keys.end() && *key <= event.downLast; ++key)
+            {
+                if (const std::optional<Point> point{crossing(first, *key, second, event.across)})
+                    result.push_back(*point);
+            }
+            break;
+        }
+        }
+    }
+}
 
-            if (y < y2)
-                ++y;
-            else if (y > y2)
-                --y;
+/**
+ * @brief Count the points where at least OVERLAP lines cross from the ends of the lines alone, however far apart they
+ *        are. A point is covered twice either by overlapping lines of the same family, which are found by merging the
+ *        lines of each family, or by lines of two families crossing, which are found by a sweep for each pair
+ *        O(n log n + k) for n lines crossing at k points
+ *
+ * @param lines
+ * @return std::size_t
+ */
+[[nodiscard]]
+static std::size_t sweptOverlapCount(const std::vector<Line>& lines)
+{
+    std::array<std::vector<Span>, FAMILY_COUNT> spans;
+    for (const Line& line : lines)
+    {
+        const std::size_t family{familyOf(line)};
+
+        const Point first{line.x, line.y};
+        const Point last{line.x + line.dx * (line.count - 1), line.y + line.dy * (line.count - 1)};
 
-            ++counts[{x, y}];
-        } while (x != x2 || y != y2);
+        spans[family].push_back({keyOf(family, first), std::min(positionOf(family, first), positionOf(family, last)),
+            std::max(positionOf(family, first), positionOf(family, last))});
     }
 
-    int answer{};
+    std::array<Coverage, FAMILY_COUNT> coverage;
+    std::size_t result{};
 
-    for (const auto&[point, count] : counts)
+    for (std::size_t family{}; family < FAMILY_COUNT; ++family)
     {
-        if (count >= 2)
+        coverage[family] = coverageOf(std::move(spans[family]));
+
+        for (const Span& run : coverage[family].overlapping)
         {
-            ++answer;
+            result += static_cast<std::size_t>(run.last - run.first + 1);
         }
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    std::vector<Point> crossings;
+    for (std::size_t first{}; first < FAMILY_COUNT; ++first)
+    {
+        for (std::size_t second{first + 1}; second < FAMILY_COUNT; ++second)
+        {
+            addCrossings(first, coverage[first].covered, second, coverage[second].covered, crossings);
+        }
+    }
+
+    // More than two families can cross at the same point
+    std::ranges::sort(crossings);
+    crossings.erase(std::unique(crossings.begin(), crossings.end()), crossings.end());
+
+    // Crossings are counted once, and no longer by every family that already counted them as overlapping
+    for (const Point& point : crossings)
+    {
+        ++result;
+        for (std::size_t family{}; family < FAMILY_COUNT; ++family)
+        {
+            if (contains(coverage[family].overlapping, family, point))
+                --result;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Count the points where at least OVERLAP lines cross the way the AOC_VENTS environment variable names:
+ *        "dense" or "sparse" to draw the lines into a raster, or "sweep" to count them without visiting every point
+ *        When it is not set, lines are drawn densely if their bounding box is small enough and swept otherwise
+ *        std::runtime_error will be thrown for any other name
+ *
+ * @param lines Must not be empty
+ * @return std::size_t
+ */
+[[nodiscard]]
+static std::size_t overlapCount(const std::vector<Line>& lines)
+{
+    const char* const requested{std::getenv("AOC_VENTS")};
+    const std::string_view method{requested == nullptr ? "" : requested};
+
+    if (method == "dense" || (method.empty() && boundsOf(lines).holdsAtMost(DENSE_CELL_LIMIT)))
+        return drawnOverlapCount(DenseRaster{boundsOf(lines)}, lines);
+    if (method == "sparse")
+        return drawnOverlapCount(SparseRaster{}, lines);
+    if (method == "sweep" || method.empty())
+        return sweptOverlapCount(lines);
+
+    throw std::runtime_error{"Unknown method \"" + std::string{method} + "\", expected dense, sparse or sweep"};
+}
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    const std::vector<Line> lines{loadLines(input)};
+
+    aoc::beginPhase("solve");
+
+    if (lines.empty())
+        return "0";
+
+    return std::to_string(overlapCount(lines));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
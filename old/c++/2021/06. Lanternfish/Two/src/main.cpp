@@ -1,22 +1,32 @@
 #include <array>
 #include <cstdint>
-#include <fstream>
-#include <iostream>
 #include <numeric>
+#include <string>
+#include <string_view>
 
-int main()
+#include "solution.hpp"
+
+namespace
+{
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
+    aoc::beginPhase("parse");
+
+    aoc::InputStream infile{input};
 
     std::array<std::uint64_t, 9> fish{};
 
-    char input;
-    while (infile.get(input))
+    char timer;
+    while (infile.get(timer))
     {
-        ++fish[static_cast<std::size_t>(input - '0')];
+        ++fish[static_cast<std::size_t>(timer - '0')];
         infile.ignore(1);
     }
 
+    aoc::beginPhase("solve");
+
     static constexpr int DAYS{256};
 
     for (int i{}; i < DAYS; ++i)
@@ -34,7 +44,9 @@ int main()
         fish[8] += readyFish;
     }
 
-    std::cout << "Answer: " << std::accumulate(fish.begin(), fish.end(), 0ull) << '\n';
+    return std::to_string(std::accumulate(fish.begin(), fish.end(), 0ull));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,22 +1,23 @@
 #include <algorithm>
 #include <cmath>
-#include <fstream>
-#include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 
-int main()
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
 {
-    std::ifstream infile{"input.txt"};
 
-    std::vector<int> crabs;
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
 
-    std::string line;
-    while (std::getline(infile, line, ','))
-    {
-        const int position{std::stoi(line)};
-        crabs.push_back(position);
-    }
+    std::vector<int> crabs{aoc::parseInts<int>(input)};
+
+    aoc::beginPhase("solve");
 
     std::sort(crabs.begin(), crabs.end());
 
@@ -29,7 +30,9 @@ int main()
         answer += std::abs(median - position);
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    return std::to_string(answer);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,11 +1,16 @@
 #include <algorithm>
 #include <cmath>
-#include <fstream>
-#include <iostream>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
 [[nodiscard]]
 static int calcFuelCostOfMoves(const int moves) noexcept
 {
@@ -25,18 +30,14 @@ static int calcFuelCostOfPoint(const std::vector<int>& crabs, const int point) n
     return result;
 }
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
+    aoc::beginPhase("parse");
 
-    std::vector<int> crabs;
+    std::vector<int> crabs{aoc::parseInts<int>(input)};
 
-    std::string line;
-    while (std::getline(infile, line, ','))
-    {
-        const int position{std::stoi(line)};
-        crabs.push_back(position);
-    }
+    aoc::beginPhase("solve");
 
     int answer{std::numeric_limits<int>::max()};
 
@@ -45,7 +46,9 @@ int main()
         answer = std::min(answer, calcFuelCostOfPoint(crabs, position));
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    return std::to_string(answer);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,7 +1,10 @@
-#include <fstream>
-#include <iostream>
-#include <sstream>
 #include <string>
+#include <string_view>
+
+#include "solution.hpp"
+
+namespace
+{
 
 [[nodiscard]]
 static constexpr bool uniqueSegmentCount(const int count) noexcept
@@ -9,14 +12,12 @@ static constexpr bool uniqueSegmentCount(const int count) noexcept
     return count == 2 || count == 4 || count == 3 || count == 7;
 }
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
-
     int answer{};
 
-    std::string line;
-    while (std::getline(infile, line))
+    for (const std::string_view line : aoc::lines(input))
     {
         const std::size_t splitPos{line.find('|')};
 
@@ -41,7 +42,9 @@ int main()
             ++answer;
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    return std::to_string(answer);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -2,15 +2,18 @@
 #include <array>
 #include <cassert>
 #include <cctype>
-#include <concepts>
 #include <cmath>
-#include <fstream>
-#include <iostream>
+#include <concepts>
 #include <iterator>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "solution.hpp"
+
+namespace
+{
+
 enum class Segment
 {
     A,
@@ -282,18 +285,16 @@ private:
     }
 };
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
-
     int answer{};
 
-    std::string line;
-    while (std::getline(infile, line))
+    for (const std::string_view line : aoc::lines(input))
     {
         std::vector<std::string> signals;
 
-        std::stringstream ss{line};
+        aoc::InputStream ss{line};
 
         SignalConverter converter;
 
@@ -381,7 +382,7 @@ int main()
             signals.push_back(std::move(signal));
         }
 
-        const int validConfigCount{converter.findValidConfigs(signals)};
+        [[maybe_unused]] const int validConfigCount{converter.findValidConfigs(signals)};
         assert(validConfigCount == 1);
 
         int displayNumber{};
@@ -404,7 +405,9 @@ int main()
         answer += displayNumber;
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    return std::to_string(answer);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
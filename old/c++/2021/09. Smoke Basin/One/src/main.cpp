@@ -1,50 +1,53 @@
 #include <cstddef>
-#include <fstream>
-#include <iostream>
 #include <string>
-#include <vector>
+#include <string_view>
 
-int main()
+#include "grid.hpp"
+#include "solution.hpp"
+
+namespace
 {
-    std::ifstream infile{"input.txt"};
 
-    std::vector<std::vector<int>> map;
+// Higher than any location
+static constexpr int BORDER_HEIGHT{10};
 
-    std::string line;
-    while (std::getline(infile, line))
-    {
-        std::vector<int>& row{map.emplace_back(line.size())};
+[[nodiscard]]
+static int toHeight(const char c) noexcept
+{
+    return c - '0';
+}
 
-        for (std::size_t i{}; i < line.size(); ++i)
-        {
-            row[i] = line[i] - '0';
-        }
-    }
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    // Surrounded by a border higher than any location, so edges need no special cases
+    const aoc::Grid<int> map{aoc::parseGrid<int>(input, toHeight, 1, BORDER_HEIGHT)};
+
+    aoc::beginPhase("solve");
 
     int answer{};
 
-    for (std::size_t y{}; y < map.size(); ++y)
+    for (std::size_t y{}; y < map.height(); ++y)
     {
-        for (std::size_t x{}; x < map[y].size(); ++x)
+        for (std::size_t x{}; x < map.width(); ++x)
         {
-            const int value{map[y][x]};
+            const int value{map(x, y)};
 
-            const bool hasNorthNeighbor{y > 0};
-            const bool hasSouthNeighbor{y < map.size() - 1};
-            const bool hasEastNeighbor{x < map[y].size() - 1};
-            const bool hasWestNeighbor{x > 0};
-
-            const bool lessThanNorth{!hasNorthNeighbor || value < map[y - 1][x]};
-            const bool lessThanSouth{!hasSouthNeighbor || value < map[y + 1][x]};
-            const bool lessThanEast{!hasEastNeighbor || value < map[y][x + 1]};
-            const bool lessThanWest{!hasWestNeighbor || value < map[y][x - 1]};
+            const bool lessThanNorth{value < map(x, y - 1)};
+            const bool lessThanSouth{value < map(x, y + 1)};
+            const bool lessThanEast{value < map(x + 1, y)};
+            const bool lessThanWest{value < map(x - 1, y)};
 
             if (lessThanNorth && lessThanSouth && lessThanEast && lessThanWest)
                 answer += value + 1;
         }
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    return std::to_string(answer);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,112 +1,404 @@
 #include <algorithm>
 #include <cstddef>
-#include <fstream>
-#include <iostream>
-#include <stack>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
-struct Coordinate
+#include "grid.hpp"
+#include "solution.hpp"
+#include "threads.hpp"
+
+namespace
 {
-    std::size_t x{};
-    std::size_t y{};
-};
 
-static void basinSize(const std::vector<std::vector<int>>& map, const std::size_t x, const std::size_t y, std::vector<std::vector<bool>>& visited, int& result)
+// Locations this high are not part of any basin
+static constexpr int RIDGE_HEIGHT{9};
+
+// Higher than any location
+static constexpr std::uint8_t BORDER_HEIGHT{10};
+
+// Number of the largest basins to multiply together
+static constexpr std::size_t LARGEST_BASIN_COUNT{3};
+
+// Large maps have basins big enough for the product of three of them to overflow 64 bits
+__extension__ using Product = unsigned __int128;
+
+// Width and height of the tiles labelled in parallel. Small enough for the labels of a tile to stay in cache
+static constexpr std::size_t TILE_SIZE{256};
+
+[[nodiscard]]
+static std::uint8_t toHeight(const char c) noexcept
 {
-    if (visited[y][x])
-        return;
-
-    ++result;
-    visited[y][x] = true;
-
-    const int value{map[y][x]};
-
-    const bool hasNorthNeighbor{y > 0};
-    const bool hasSouthNeighbor{y < map.size() - 1};
-    const bool hasEastNeighbor{x < map[y].size() - 1};
-    const bool hasWestNeighbor{x > 0};
-
-    // North
-    if (hasNorthNeighbor && value < map[y - 1][x] && map[y - 1][x] != 9)
-        basinSize(map, x, y - 1, visited, result);
-    // South
-    if (hasSouthNeighbor && value < map[y + 1][x] && map[y + 1][x] != 9)
-        basinSize(map, x, y + 1, visited, result);
-    // East
-    if (hasEastNeighbor && value < map[y][x + 1] && map[y][x + 1] != 9)
-        basinSize(map, x + 1, y, visited, result);
-    // West
-    if (hasWestNeighbor && value < map[y][x - 1] && map[y][x - 1] != 9)
-        basinSize(map, x - 1, y, visited, result);
+    return static_cast<std::uint8_t>(c - '0');
 }
 
+/**
+ * @brief Size of every basin in one pass over map. Every location below RIDGE_HEIGHT is part of exactly one basin,
+ *        so each one not yet visited starts a new basin that is filled out with an explicit stack
+ *        The visited mask and stack are shared by every basin, so nothing is allocated per basin and deep basins can
+ *        not overflow the call stack
+ *
+ * @param map Padded by at least 1 with a border of at least RIDGE_HEIGHT
+ * @return std::vector<std::size_t>
+ */
 [[nodiscard]]
-static int basinSize(const std::vector<std::vector<int>>& map, const std::size_t x, const std::size_t y)
+static std::vector<std::size_t> sequentialBasinSizes(const aoc::Grid<std::uint8_t>& map)
 {
-    int result{0};
+    std::vector<std::size_t> sizes;
+
+    // Same shape as map so positions line up
+    aoc::Grid<bool> visited(map.width(), map.height(), false, map.padding());
+
+    // Locations found but not yet explored
+    std::vector<std::size_t> pending;
 
-    std::vector<std::vector<bool>> visited(map.size());
-    for (std::size_t i{}; i < map.size(); ++i)
+    for (std::size_t y{}; y < map.height(); ++y)
     {
-        visited[i].resize(map[i].size());
-    }
+        for (std::size_t x{}; x < map.width(); ++x)
+        {
+            const std::size_t start{map.index(x, y)};
+            if (map[start] >= RIDGE_HEIGHT || visited.testAndSet(start))
+                continue;
 
-    basinSize(map, x, y, visited, result);
+            std::size_t size{0};
+            pending.push_back(start);
 
-    return result;
+            while (!pending.empty())
+            {
+                const std::size_t position{pending.back()};
+                pending.pop_back();
+                ++size;
+
+                // Ridges and the border stop the fill, so no bounds checks are needed
+                for (const std::size_t neighbor : map.orthogonal(position))
+                {
+                    if (map[neighbor] < RIDGE_HEIGHT && !visited.testAndSet(neighbor))
+                        pending.push_back(neighbor);
+                }
+            }
+
+            sizes.push_back(size);
+        }
+    }
+
+    return sizes;
 }
 
-int main()
+/**
+ * @brief Basins of one tile, labelled 1 and up without looking past the edges of the tile
+ *
+ */
+struct TileBasins
+{
+    // Labels of cells that are not in any basin
+    static constexpr std::uint32_t RIDGE{std::numeric_limits<std::uint32_t>::max()};
+
+    // Size of the basin with each label, starting from label 1
+    std::vector<std::size_t> sizes;
+
+    // Labels of the cells along each edge, so basins cut by the edges can be joined up again
+    std::vector<std::uint32_t> top;
+    std::vector<std::uint32_t> bottom;
+    std::vector<std::uint32_t> left;
+    std::vector<std::uint32_t> right;
+};
+
+/**
+ * @brief Label the basins of the width * height tile with its top left corner at (x, y), as if nothing outside of it
+ *        existed. Basins that cross an edge are split, and are counted separately in each tile
+ *
+ * @param map
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ * @return TileBasins
+ */
+[[nodiscard]]
+static TileBasins labelTile(const aoc::Grid<std::uint8_t>& map, const std::size_t x, const std::size_t y,
+    const std::size_t width, const std::size_t height)
 {
-    std::ifstream infile{"input.txt"};
+    static constexpr std::uint32_t UNLABELLED{0};
 
-    std::vector<std::vector<int>> map;
+    TileBasins result;
 
-    std::string line;
-    while (std::getline(infile, line))
+    // Ridges and the border stop the fill, so no bounds checks are needed
+    aoc::Grid<std::uint32_t> labels(width, height, UNLABELLED, 1, TileBasins::RIDGE);
+    for (std::size_t tileY{}; tileY < height; ++tileY)
     {
-        std::vector<int>& row{map.emplace_back(line.size())};
+        for (std::size_t tileX{}; tileX < width; ++tileX)
+        {
+            if (map(x + tileX, y + tileY) >= RIDGE_HEIGHT)
+                labels(tileX, tileY) = TileBasins::RIDGE;
+        }
+    }
 
-        for (std::size_t i{}; i < line.size(); ++i)
+    // Locations found but not yet explored
+    std::vector<std::size_t> pending;
+
+    for (std::size_t tileY{}; tileY < height; ++tileY)
+    {
+        for (std::size_t tileX{}; tileX < width; ++tileX)
         {
-            row[i] = line[i] - '0';
+            const std::size_t start{labels.index(tileX, tileY)};
+            if (labels[start] != UNLABELLED)
+                continue;
+
+            const std::uint32_t label{static_cast<std::uint32_t>(result.sizes.size() + 1)};
+            std::size_t size{0};
+
+            labels[start] = label;
+            pending.push_back(start);
+
+            while (!pending.empty())
+            {
+                const std::size_t position{pending.back()};
+                pending.pop_back();
+                ++size;
+
+                for (const std::size_t neighbor : labels.orthogonal(position))
+                {
+                    if (labels[neighbor] == UNLABELLED)
+                    {
+                        labels[neighbor] = label;
+                        pending.push_back(neighbor);
+                    }
+                }
+            }
+
+            result.sizes.push_back(size);
         }
     }
 
-    std::vector<int> basins;
+    std::ranges::copy(labels.row(0), std::back_inserter(result.top));
+    std::ranges::copy(labels.row(height - 1), std::back_inserter(result.bottom));
+    std::ranges::copy(labels.column(0), std::back_inserter(result.left));
+    std::ranges::copy(labels.column(width - 1), std::back_inserter(result.right));
+
+    return result;
+}
 
-    for (std::size_t y{}; y < map.size(); ++y)
+/**
+ * @brief Disjoint sets of ids in [0, size), each knowing the total size of the basins in it
+ *
+ */
+class BasinSets
+{
+public:
+    explicit BasinSets(std::vector<std::size_t>&& a_sizes) :
+        parents(a_sizes.size()), sizes{std::move(a_sizes)}
     {
-        for (std::size_t x{}; x < map[y].size(); ++x)
+        for (std::size_t i{}; i < this->parents.size(); ++i)
         {
-            const int value{map[y][x]};
+            this->parents[i] = i;
+        }
+    }
+
+    [[nodiscard]]
+    std::size_t find(std::size_t id) noexcept
+    {
+        // Path halving: point every other node on the way at its grandparent
+        while (this->parents[id] != id)
+        {
+            this->parents[id] = this->parents[this->parents[id]];
+            id = this->parents[id];
+        }
 
-            const bool hasNorthNeighbor{y > 0};
-            const bool hasSouthNeighbor{y < map.size() - 1};
-            const bool hasEastNeighbor{x < map[y].size() - 1};
-            const bool hasWestNeighbor{x > 0};
+        return id;
+    }
+
+    /**
+     * @brief Join the sets of a and b, keeping the larger as the root so paths stay short
+     *
+     * @param a
+     * @param b
+     */
+    void unite(std::size_t a, std::size_t b) noexcept
+    {
+        a = this->find(a);
+        b = this->find(b);
+        if (a == b)
+            return;
 
-            const bool lessThanNorth{!hasNorthNeighbor || value < map[y - 1][x]};
-            const bool lessThanSouth{!hasSouthNeighbor || value < map[y + 1][x]};
-            const bool lessThanEast{!hasEastNeighbor || value < map[y][x + 1]};
-            const bool lessThanWest{!hasWestNeighbor || value < map[y][x - 1]};
+        if (this->sizes[a] < this->sizes[b])
+            std::swap(a, b);
 
-            if (lessThanNorth && lessThanSouth && lessThanEast && lessThanWest)
-                basins.push_back(basinSize(map, x, y));
+        this->parents[b] = a;
+        this->sizes[a] += this->sizes[b];
+    }
+
+    /**
+     * @brief Total size of every set
+     *
+     * @return std::vector<std::size_t>
+     */
+    [[nodiscard]]
+    std::vector<std::size_t> setSizes() const
+    {
+        std::vector<std::size_t> result;
+        for (std::size_t i{}; i < this->parents.size(); ++i)
+        {
+            if (this->parents[i] == i)
+                result.push_back(this->sizes[i]);
         }
+
+        return result;
+    }
+private:
+    std::vector<std::size_t> parents;
+    std::vector<std::size_t> sizes;
+};
+
+/**
+ * @brief Join the basins on either side of a shared tile edge. Cells at the same position along the edges touch
+ *
+ * @param sets
+ * @param first Labels along the edge of one tile
+ * @param firstOffset Id of label 1 in that tile
+ * @param second Labels along the edge of the other tile
+ * @param secondOffset Id of label 1 in the other tile
+ */
+static void joinEdge(BasinSets& sets, const std::vector<std::uint32_t>& first, const std::size_t firstOffset,
+    const std::vector<std::uint32_t>& second, const std::size_t secondOffset)
+{
+    for (std::size_t i{}; i < first.size(); ++i)
+    {
+        if (first[i] != TileBasins::RIDGE && second[i] != TileBasins::RIDGE)
+            sets.unite(firstOffset + first[i] - 1, secondOffset + second[i] - 1);
     }
+}
+
+/**
+ * @brief Same as sequentialBasinSizes, but the map is cut into tiles that are labelled in parallel on pool
+ *        Basins split by tile edges are then joined back together with a union-find over the labels along the edges,
+ *        which is a tiny fraction of the map
+ *
+ * @param map Padded by at least 1 with a border of at least RIDGE_HEIGHT
+ * @param pool
+ * @return std::vector<std::size_t>
+ */
+[[nodiscard]]
+static std::vector<std::size_t> tiledBasinSizes(const aoc::Grid<std::uint8_t>& map, aoc::ThreadPool& pool)
+{
+    const std::size_t tilesX{(map.width() + TILE_SIZE - 1) / TILE_SIZE};
+    const std::size_t tilesY{(map.height() + TILE_SIZE - 1) / TILE_SIZE};
+
+    // Row by row, like the cells of a grid
+    std::vector<TileBasins> tiles(tilesX * tilesY);
+
+    pool.parallelFor(tiles.size(), [&map, &tiles, tilesX](const std::size_t tile) -> void
+    {
+        const std::size_t x{tile % tilesX * TILE_SIZE};
+        const std::size_t y{tile / tilesX * TILE_SIZE};
+
+        tiles[tile] = labelTile(map, x, y, std::min(TILE_SIZE, map.width() - x), std::min(TILE_SIZE, map.height() - y));
+    });
+
+    // Every basin of every tile gets its own id, numbered tile by tile
+    std::vector<std::size_t> offsets(tiles.size());
+    std::vector<std::size_t> sizes;
+    for (std::size_t tile{}; tile < tiles.size(); ++tile)
+    {
+        offsets[tile] = sizes.size();
+        sizes.insert(sizes.end(), tiles[tile].sizes.begin(), tiles[tile].sizes.end());
+    }
+
+    BasinSets sets{std::move(sizes)};
+
+    for (std::size_t tile{}; tile < tiles.size(); ++tile)
+    {
+        // Tile to the right
+        if (tile % tilesX + 1 < tilesX)
+            joinEdge(sets, tiles[tile].right, offsets[tile], tiles[tile + 1].left, offsets[tile + 1]);
+
+        // Tile below
+        if (tile / tilesX + 1 < tilesY)
+            joinEdge(sets, tiles[tile].bottom, offsets[tile], tiles[tile + tilesX].top, offsets[tile + tilesX]);
+    }
+
+    return sets.setSizes();
+}
 
-    std::sort(basins.rbegin(), basins.rend());
+/**
+ * @brief Size of every basin. Maps bigger than a tile are labelled in parallel when more than one thread is allowed,
+ *        and sequentially otherwise. Both give the same sizes, in a different order
+ *
+ * @param map Padded by at least 1 with a border of at least RIDGE_HEIGHT
+ * @return std::vector<std::size_t>
+ */
+[[nodiscard]]
+static std::vector<std::size_t> basinSizes(const aoc::Grid<std::uint8_t>& map)
+{
+    if (aoc::threadCount() == 1 || (map.width() <= TILE_SIZE && map.height() <= TILE_SIZE))
+        return sequentialBasinSizes(map);
 
-    int answer{1};
+    return tiledBasinSizes(map, aoc::threadPool());
+}
 
-    for (std::size_t i{}; i < 3 && i < basins.size(); ++i)
+/**
+ * @brief std::to_string for Product
+ *
+ * @param value
+ * @return std::string
+ */
+[[nodiscard]]
+static std::string toString(Product value)
+{
+    std::string result;
+    do
     {
-        answer *= basins[i];
+        result.push_back(static_cast<char>('0' + static_cast<int>(value % 10)));
+        value /= 10;
+    } while (value != 0);
+
+    std::ranges::reverse(result);
+
+    return result;
+}
+
+/**
+ * @brief Product of the count largest sizes. Only those are partitioned to the front, the rest are left unsorted
+ *        std::overflow_error will be thrown if it does not fit in a Product
+ *
+ * @param sizes
+ * @param count
+ * @return Product
+ */
+[[nodiscard]]
+static Product productOfLargest(std::vector<std::size_t> sizes, const std::size_t count)
+{
+    const auto largestEnd{sizes.begin() + static_cast<std::ptrdiff_t>(std::min(count, sizes.size()))};
+    std::nth_element(sizes.begin(), largestEnd, sizes.end(), std::greater{});
+
+    Product result{1};
+    for (auto size{sizes.begin()}; size != largestEnd; ++size)
+    {
+        if (__builtin_mul_overflow(result, Product{*size}, &result))
+            throw std::overflow_error{"Product of the largest basins does not fit in 128 bits"};
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    return result;
+}
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    // Surrounded by a border higher than any location, so edges need no special cases
+    const aoc::Grid<std::uint8_t> map{aoc::parseGrid<std::uint8_t>(input, toHeight, 1, BORDER_HEIGHT)};
+
+    aoc::beginPhase("solve");
+
+    return toString(productOfLargest(basinSizes(map), LARGEST_BASIN_COUNT));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
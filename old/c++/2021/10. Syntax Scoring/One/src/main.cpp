@@ -1,29 +1,24 @@
 #include <cassert>
-#include <cstdlib>
-#include <fstream>
-#include <iostream>
 #include <stack>
 #include <string>
+#include <string_view>
+
+#include "solution.hpp"
+
+namespace
+{
 
 static constexpr int PAREN_SCORE{3};
 static constexpr int SQUARE_BRACKET_SCORE{57};
 static constexpr int CURLY_BRACKET_SCORE{1197};
 static constexpr int ANGLED_BRACKET_SCORE{25137};
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
-
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open file!\n";
-        return EXIT_FAILURE;
-    }
-
     int answer{};
 
-    std::string line;
-    while (std::getline(infile, line))
+    for (const std::string_view line : aoc::lines(input))
     {
         std::stack<char> stack;
 
@@ -89,7 +84,9 @@ int main()
         }
     }
 
-    std::cout << "Answer: " << answer << '\n';
+    return std::to_string(answer);
+}
+
+}
 
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
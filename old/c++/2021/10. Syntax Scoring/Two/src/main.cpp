@@ -1,11 +1,15 @@
+#include <algorithm>
 #include <cstdint>
-#include <cstdlib>
-#include <fstream>
-#include <iostream>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "solution.hpp"
+
+namespace
+{
+
 enum Score
 {
     PAREN = 1,
@@ -14,22 +18,14 @@ enum Score
     ANGLED_BRACKET
 };
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
-
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open file!\n";
-        return EXIT_FAILURE;
-    }
-
     // Score of each line
     std::vector<std::uint64_t> scores;
 
     // Read file line by line
-    std::string line;
-    while (std::getline(infile, line))
+    for (const std::string_view line : aoc::lines(input))
     {
         std::stack<char> stack;
 
@@ -136,7 +132,9 @@ int main()
 
     std::sort(scores.begin(), scores.end());
 
-    std::cout << "Answer: " << scores[scores.size() / 2] << '\n';
+    return std::to_string(scores[scores.size() / 2]);
+}
+
+}
 
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
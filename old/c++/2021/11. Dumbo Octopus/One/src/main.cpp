@@ -1,8 +1,12 @@
 #include <cstddef>
-#include <fstream>
-#include <iostream>
 #include <string>
-#include <vector>
+#include <string_view>
+
+#include "grid.hpp"
+#include "solution.hpp"
+
+namespace
+{
 
 struct Octopus
 {
@@ -13,39 +17,37 @@ struct Octopus
 class Map
 {
 public:
-    void addRow(const std::string& line)
-    {
-        std::vector<Octopus>& row{map.emplace_back(line.size())};
-
-        for (std::size_t i{}; i < line.size(); ++i)
+    // The border soaks up flashes from the edges, so flash needs no bounds checks
+    explicit Map(const std::string_view input) :
+        map{aoc::parseGrid<Octopus>(input, [](const char c) -> Octopus
         {
-            row[i].energy = line[i] - '0';
-        }
-    }
+            return {c - '0', false};
+        }, 1)}
+    {}
 
     void resetStatus() noexcept
     {
-        for (std::size_t y{}; y < this->map.size(); ++y)
+        for (Octopus& octopus : this->map.cellsWithBorder())
         {
-            for (std::size_t x{}; x < this->map[y].size(); ++x)
+            if (octopus.flashed)
             {
-                if (map[y][x].flashed)
-                {
-                    map[y][x].energy = 0;
-                    map[y][x].flashed = false;
-                }
+                octopus.energy = 0;
+                octopus.flashed = false;
             }
         }
+
+        // Energy spilled into the border is never read, but clearing it keeps it from growing without bound
+        this->map.fillBorder({});
     }
 
     [[nodiscard]]
     bool stepDone() const noexcept
     {
-        for (std::size_t y{}; y < this->map.size(); ++y)
+        for (std::size_t y{}; y < this->map.height(); ++y)
         {
-            for (std::size_t x{}; x < this->map[y].size(); ++x)
+            for (const Octopus& octopus : this->map.row(y))
             {
-                if (map[y][x].energy > 9 && !map[y][x].flashed)
+                if (octopus.energy > 9 && !octopus.flashed)
                     return false;
             }
         }
@@ -57,35 +59,12 @@ public:
     {
         ++this->flashCount;
 
-        const bool hasNorthNeighbor{y > 0};
-        const bool hasSouthNeighbor{y < this->map.size() - 1};
-        const bool hasEastNeighbor{x < this->map[0].size() - 1};
-        const bool hasWestNeighbor{x > 0};
-
-        const bool hasNorthEastNeighbor{hasNorthNeighbor && hasEastNeighbor};
-        const bool hasNorthWestNeighbor{hasNorthNeighbor && hasWestNeighbor};
-        const bool hasSouthEastNeighbor{hasSouthNeighbor && hasEastNeighbor};
-        const bool hasSouthWestNeighbor{hasSouthNeighbor && hasWestNeighbor};
-
-        if (hasNorthNeighbor)
-            ++this->map[y - 1][x].energy;
-        if (hasSouthNeighbor)
-            ++this->map[y + 1][x].energy;
-        if (hasEastNeighbor)
-            ++this->map[y][x + 1].energy;
-        if (hasWestNeighbor)
-            ++this->map[y][x - 1].energy;
-
-        if (hasNorthEastNeighbor)
-            ++this->map[y - 1][x + 1].energy;
-        if (hasNorthWestNeighbor)
-            ++this->map[y - 1][x - 1].energy;
-        if (hasSouthEastNeighbor)
-            ++this->map[y + 1][x + 1].energy;
-        if (hasSouthWestNeighbor)
-            ++this->map[y + 1][x - 1].energy;
-
-        this->map[y][x].flashed = true;
+        for (const std::size_t neighbor : this->map.adjacent(this->map.index(x, y)))
+        {
+            ++this->map[neighbor].energy;
+        }
+
+        this->map(x, y).flashed = true;
     }
 
     [[nodiscard]]
@@ -95,43 +74,40 @@ public:
     }
 
     [[nodiscard]]
-    std::size_t size() const noexcept
+    std::size_t width() const noexcept
     {
-        return this->map.size();
+        return this->map.width();
     }
 
     [[nodiscard]]
-    std::vector<Octopus>& operator[](const std::size_t y)
+    std::size_t height() const noexcept
     {
-        return this->map[y];
+        return this->map.height();
+    }
+
+    [[nodiscard]]
+    Octopus& operator()(const std::size_t x, const std::size_t y) noexcept
+    {
+        return this->map(x, y);
     }
 private:
-    std::vector<std::vector<Octopus>> map;
+    aoc::Grid<Octopus> map;
     int flashCount{};
 };
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
     // Number of steps to simulate
     static constexpr int STEP_COUNT{100};
 
-    std::ifstream infile{"input.txt"};
-
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open file!\n";
-        return -1;
-    }
-
-    Map map;
+    aoc::beginPhase("parse");
 
     // Load input file
 
-    std::string line;
-    while (std::getline(infile, line))
-    {
-        map.addRow(line);
-    }
+    Map map{input};
+
+    aoc::beginPhase("solve");
 
     // Main loop
 
@@ -139,11 +115,11 @@ int main()
     {
         // Increase energy level of each octopus
 
-        for (std::size_t y{}; y < map.size(); ++y)
+        for (std::size_t y{}; y < map.height(); ++y)
         {
-            for (std::size_t x{}; x < map[y].size(); ++x)
+            for (std::size_t x{}; x < map.width(); ++x)
             {
-                ++map[y][x].energy;
+                ++map(x, y).energy;
             }
         }
 
@@ -151,11 +127,11 @@ int main()
 
         while (!map.stepDone())
         {
-            for (std::size_t y{}; y < map.size(); ++y)
+            for (std::size_t y{}; y < map.height(); ++y)
             {
-                for (std::size_t x{}; x < map[y].size(); ++x)
+                for (std::size_t x{}; x < map.width(); ++x)
                 {
-                    if (map[y][x].energy > 9 && !map[y][x].flashed)
+                    if (map(x, y).energy > 9 && !map(x, y).flashed)
                     {
                         map.flash(x, y);
                     }
@@ -167,7 +143,9 @@ int main()
         map.resetStatus();
     }
 
-    std::cout << "Answer: " << map.flashes() << '\n';
+    return std::to_string(map.flashes());
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,190 +1,437 @@
+#include <algorithm>
+#include <bit>
 #include <cstddef>
-#include <fstream>
-#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
-struct Octopus
+#include "grid.hpp"
+#include "parse.hpp"
+#include "simd.hpp"
+#include "solution.hpp"
+
+namespace
 {
-    int energy{};
-    bool flashed{};
-};
 
-class Map
+// Energy at which an octopus flashes
+static constexpr std::uint8_t FLASH_ENERGY{10};
+
+// Zobrist key of a cell at energy e is its random key rotated by e * KEY_ROTATION. Energies never pass 18, so every
+// energy a cell can have gets its own rotation
+static constexpr int KEY_ROTATION{3};
+
+[[nodiscard]]
+static std::uint8_t toEnergy(const char c) noexcept
+{
+    return static_cast<std::uint8_t>(c - '0');
+}
+
+/**
+ * @brief Next value of the SplitMix64 sequence. Fast and plenty random for hash keys
+ *
+ * @param state
+ * @return std::uint64_t
+ */
+[[nodiscard]]
+static std::uint64_t splitMix64(std::uint64_t& state) noexcept
+{
+    std::uint64_t result{state += 0x9E3779B97F4A7C15};
+    result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9;
+    result = (result ^ (result >> 27)) * 0x94D049BB133111EB;
+    return result ^ (result >> 31);
+}
+
+/**
+ * @brief Energy of every octopus in a flat grid, with a border that soaks up flashes from the edges
+ *        Steps are driven by the flashes themselves: after the bump every octopus gets, only octopuses that flash and
+ *        their neighbors are touched, instead of rescanning the grid for each wave of the cascade
+ *        A Zobrist hash of the energies is kept up to date along the way. Rotating every key distributes over XOR, so
+ *        the bump is a single rotation of the hash and only cells touched by flashes are rehashed one by one
+ *
+ */
+class Cavern
 {
 public:
-    void addRow(const std::string& line)
+    explicit Cavern(const std::string_view input) :
+        energies{aoc::parseGrid<std::uint8_t>(input, toEnergy, 1)}, keys(this->energies.cellCount(), 0)
     {
-        std::vector<Octopus>& row{map.emplace_back(line.size())};
+        this->flashed.reserve(this->area());
 
-        for (std::size_t i{}; i < line.size(); ++i)
+        // Border keys stay 0 so flashes spilling into the border leave the hash alone
+        std::uint64_t seed{0};
+        for (std::size_t y{}; y < this->energies.height(); ++y)
         {
-            row[i].energy = line[i] - '0';
+            for (std::size_t x{}; x < this->energies.width(); ++x)
+            {
+                const std::size_t position{this->energies.index(x, y)};
+
+                this->keys[position] = splitMix64(seed);
+                this->stateHash ^= this->key(position, this->energies[position]);
+            }
         }
     }
 
-    void resetStatus() noexcept
+    [[nodiscard]]
+    std::size_t area() const noexcept
+    {
+        return this->energies.width() * this->energies.height();
+    }
+
+    /**
+     * @brief Advance one step
+     *
+     * @return std::size_t Number of octopuses that flashed
+     */
+    std::size_t step()
     {
-        this->m_flashesThisStep = 0;
+        this->flashed.clear();
 
-        for (std::size_t y{}; y < this->map.size(); ++y)
+        // Every octopus gains 1 energy, and those that reach FLASH_ENERGY start the cascade
+        this->bump();
+        this->stateHash = std::rotl(this->stateHash, KEY_ROTATION);
+
+        // An octopus is queued exactly once, when its energy first reaches FLASH_ENERGY, and everything queued
+        // flashes, so the queue doubles as the list of octopuses to reset
+        for (std::size_t i{}; i < this->flashed.size(); ++i)
         {
-            for (std::size_t x{}; x < this->map[y].size(); ++x)
+            for (const std::size_t neighbor : this->energies.adjacent(this->flashed[i]))
             {
-                if (map[y][x].flashed)
-                {
-                    map[y][x].energy = 0;
-                    map[y][x].flashed = false;
-                }
+                std::uint8_t& energy{this->energies[neighbor]};
+                this->stateHash ^= this->key(neighbor, energy) ^ this->key(neighbor, energy + 1);
+
+                if (++energy == FLASH_ENERGY)
+                    this->flashed.push_back(neighbor);
             }
         }
+
+        for (const std::size_t position : this->flashed)
+        {
+            this->stateHash ^= this->key(position, this->energies[position]) ^ this->key(position, 0);
+            this->energies[position] = 0;
+        }
+
+        // The border gains at most 4 a step, so clearing it every step keeps it from ever reaching FLASH_ENERGY
+        this->energies.fillBorder(0);
+
+        return this->flashed.size();
+    }
+
+    /**
+     * @brief Zobrist hash of every energy. Equal states always hash the same
+     *
+     * @return std::uint64_t
+     */
+    [[nodiscard]]
+    std::uint64_t hash() const noexcept
+    {
+        return this->stateHash;
     }
 
+    /**
+     * @brief Whether every octopus has the same energy as in other, for confirming that equal hashes are equal states
+     *
+     * @param other Cavern loaded from the same input
+     * @return true if the states match, else false
+     */
     [[nodiscard]]
-    bool stepDone() const noexcept
+    bool sameState(const Cavern& other) const noexcept
     {
-        for (std::size_t y{}; y < this->map.size(); ++y)
+        return std::ranges::equal(this->energies.cellsWithBorder(), other.energies.cellsWithBorder());
+    }
+private:
+    aoc::Grid<std::uint8_t> energies;
+
+    // Random key of every cell, laid out like energies
+    std::vector<std::uint64_t> keys;
+    std::uint64_t stateHash{};
+
+    // Octopuses that flashed this step, in the order they did
+    std::vector<std::size_t> flashed;
+
+    [[nodiscard]]
+    std::uint64_t key(const std::size_t position, const int energy) const noexcept
+    {
+        return std::rotl(this->keys[position], energy * KEY_ROTATION);
+    }
+
+    /**
+     * @brief Add 1 to every cell, border included, and queue every cell that reaches FLASH_ENERGY
+     *        Bumping the whole buffer in one run is cheaper than skipping the border around each row
+     *
+     */
+    void bump()
+    {
+        const std::span<std::uint8_t> cells{this->energies.cellsWithBorder()};
+        std::size_t position{};
+
+#ifdef AOC_SIMD_X86
+        switch (aoc::simd::level())
         {
-            for (std::size_t x{}; x < this->map[y].size(); ++x)
-            {
-                if (map[y][x].energy > 9 && !map[y][x].flashed)
-                    return false;
-            }
+        case aoc::simd::Level::AVX2:
+            position = this->bumpAvx2(cells);
+            break;
+        case aoc::simd::Level::SSE2:
+            position = this->bumpSse2(cells, 0);
+            break;
+        case aoc::simd::Level::Scalar:
+            break;
+        }
+#endif
+
+        for (; position < cells.size(); ++position)
+        {
+            if (++cells[position] == FLASH_ENERGY)
+                this->flashed.push_back(position);
+        }
+    }
+
+    /**
+     * @brief Queue the cells at first plus each set bit of mask
+     *
+     * @param first
+     * @param mask
+     */
+    void queueFlashes(const std::size_t first, unsigned int mask)
+    {
+        for (; mask != 0; mask &= mask - 1)
+        {
+            this->flashed.push_back(first + static_cast<std::size_t>(std::countr_zero(mask)));
+        }
+    }
+
+#ifdef AOC_SIMD_X86
+    // Both kernels bump whole blocks from position on and return where the first partial block starts
+
+    [[gnu::target("sse2")]]
+    std::size_t bumpSse2(const std::span<std::uint8_t> cells, std::size_t position)
+    {
+        const __m128i one{_mm_set1_epi8(1)};
+        const __m128i flash{_mm_set1_epi8(static_cast<char>(FLASH_ENERGY))};
+
+        for (; cells.size() - position >= 16; position += 16)
+        {
+            __m128i* const block{reinterpret_cast<__m128i*>(cells.data() + position)};
+
+            const __m128i bumped{_mm_add_epi8(_mm_loadu_si128(block), one)};
+            _mm_storeu_si128(block, bumped);
+
+            this->queueFlashes(position, static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(bumped, flash))));
         }
 
-        return true;
+        return position;
     }
 
-    void flash(const std::size_t x, const std::size_t y)
+    [[gnu::target("avx2")]]
+    std::size_t bumpAvx2(const std::span<std::uint8_t> cells)
     {
-        ++this->m_flashesThisStep;
+        const __m256i one{_mm256_set1_epi8(1)};
+        const __m256i flash{_mm256_set1_epi8(static_cast<char>(FLASH_ENERGY))};
 
-        const bool hasNorthNeighbor{y > 0};
-        const bool hasSouthNeighbor{y < this->map.size() - 1};
-        const bool hasEastNeighbor{x < this->map[0].size() - 1};
-        const bool hasWestNeighbor{x > 0};
+        std::size_t position{};
+        for (; cells.size() - position >= 32; position += 32)
+        {
+            __m256i* const block{reinterpret_cast<__m256i*>(cells.data() + position)};
 
-        const bool hasNorthEastNeighbor{hasNorthNeighbor && hasEastNeighbor};
-        const bool hasNorthWestNeighbor{hasNorthNeighbor && hasWestNeighbor};
-        const bool hasSouthEastNeighbor{hasSouthNeighbor && hasEastNeighbor};
-        const bool hasSouthWestNeighbor{hasSouthNeighbor && hasWestNeighbor};
+            const __m256i bumped{_mm256_add_epi8(_mm256_loadu_si256(block), one)};
+            _mm256_storeu_si256(block, bumped);
 
-        if (hasNorthNeighbor)
-            ++this->map[y - 1][x].energy;
-        if (hasSouthNeighbor)
-            ++this->map[y + 1][x].energy;
-        if (hasEastNeighbor)
-            ++this->map[y][x + 1].energy;
-        if (hasWestNeighbor)
-            ++this->map[y][x - 1].energy;
+            this->queueFlashes(position,
+                static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bumped, flash))));
+        }
 
-        if (hasNorthEastNeighbor)
-            ++this->map[y - 1][x + 1].energy;
-        if (hasNorthWestNeighbor)
-            ++this->map[y - 1][x - 1].energy;
-        if (hasSouthEastNeighbor)
-            ++this->map[y + 1][x + 1].energy;
-        if (hasSouthWestNeighbor)
-            ++this->map[y + 1][x - 1].energy;
+        return this->bumpSse2(cells, position);
+    }
+#endif
+};
+
+/**
+ * @brief Flash counts of a cavern, simulated only until it returns to an earlier state
+ *        Every step after that repeats the cycle between the two, so any step, however far off, is answered from the
+ *        recorded steps without simulating up to it
+ *
+ */
+class FlashHistory
+{
+public:
+    /**
+     * @brief Simulate until the first repeated state
+     *
+     * @param a_initial
+     */
+    explicit FlashHistory(const Cavern& a_initial) :
+        initial{a_initial}
+    {
+        Cavern cavern{this->initial};
 
-        this->map[y][x].flashed = true;
+        // Step after which each hash was first seen
+        std::unordered_map<std::uint64_t, std::size_t> seen{{cavern.hash(), 0}};
+
+        while (true)
+        {
+            this->flashTotals.push_back(this->flashTotals.back() + cavern.step());
+            const std::size_t step{this->flashTotals.size() - 1};
+
+            const auto[earlier, inserted]{seen.try_emplace(cavern.hash(), step)};
+            if (inserted)
+                continue;
+
+            // Equal hashes are almost certainly equal states, but a collision must not be taken for a cycle
+            if (!this->stateAt(earlier->second).sameState(cavern))
+                continue;
+
+            this->cycleStart_ = earlier->second;
+            this->cycleLength_ = step - earlier->second;
+            return;
+        }
     }
 
+    /**
+     * @brief First step whose state is repeated later
+     *
+     * @return std::size_t
+     */
     [[nodiscard]]
-    constexpr int flashesThisStep() const noexcept
+    std::size_t cycleStart() const noexcept
     {
-        return this->m_flashesThisStep;
+        return this->cycleStart_;
     }
 
+    /**
+     * @brief Steps between repeats of the same state
+     *
+     * @return std::size_t
+     */
     [[nodiscard]]
-    std::size_t size() const noexcept
+    std::size_t cycleLength() const noexcept
     {
-        return this->map.size();
+        return this->cycleLength_;
     }
 
+    /**
+     * @brief Total flashes over the first steps steps
+     *
+     * @param steps
+     * @return std::uint64_t
+     */
     [[nodiscard]]
-    int area() const noexcept
+    std::uint64_t flashesAfter(const std::uint64_t steps) const noexcept
     {
-        int result{};
+        if (steps < this->flashTotals.size())
+            return this->flashTotals[steps];
 
-        for (std::size_t y{}; y < this->map.size(); ++y)
+        const std::uint64_t cycles{(steps - this->cycleStart_) / this->cycleLength_};
+        const std::uint64_t remainder{(steps - this->cycleStart_) % this->cycleLength_};
+
+        const std::uint64_t beforeCycle{this->flashTotals[this->cycleStart_]};
+        const std::uint64_t perCycle{this->flashTotals[this->cycleStart_ + this->cycleLength_] - beforeCycle};
+
+        return beforeCycle + cycles * perCycle + (this->flashTotals[this->cycleStart_ + remainder] - beforeCycle);
+    }
+
+    /**
+     * @brief The cavern after step steps, reached by simulating no further than the end of the first cycle
+     *
+     * @param step
+     * @return Cavern
+     */
+    [[nodiscard]]
+    Cavern stateAt(const std::uint64_t step) const
+    {
+        std::uint64_t equivalent{step};
+        if (this->cycleLength_ != 0 && step > this->cycleStart_)
+            equivalent = this->cycleStart_ + (step - this->cycleStart_) % this->cycleLength_;
+
+        Cavern cavern{this->initial};
+        for (std::uint64_t i{}; i < equivalent; ++i)
         {
-            for (std::size_t x{}; x < this->map[y].size(); ++x)
-            {
-                ++result;
-            }
+            static_cast<void>(cavern.step());
         }
 
-        return result;
+        return cavern;
     }
 
+    /**
+     * @brief First step during which every octopus flashes
+     *
+     * @return std::optional<std::uint64_t> Nothing if they never do
+     */
     [[nodiscard]]
-    std::vector<Octopus>& operator[](const std::size_t y)
+    std::optional<std::uint64_t> firstSynchronizedStep() const noexcept
     {
-        return this->map[y];
+        // Only the steps up to the end of the first cycle can be new
+        const std::uint64_t area{this->initial.area()};
+        for (std::size_t step{1}; step < this->flashTotals.size(); ++step)
+        {
+            if (this->flashTotals[step] - this->flashTotals[step - 1] == area)
+                return step;
+        }
+
+        return std::nullopt;
     }
 private:
-    std::vector<std::vector<Octopus>> map;
-    int m_flashesThisStep{};
+    Cavern initial;
+
+    // Total flashes after each step, starting from 0 steps
+    std::vector<std::uint64_t> flashTotals{0};
+
+    std::size_t cycleStart_{};
+    std::size_t cycleLength_{};
 };
 
-int main()
+/**
+ * @brief Value of the environment variable name as a number, or nothing when it is not set
+ *
+ * @param name
+ * @return std::optional<std::uint64_t>
+ */
+[[nodiscard]]
+static std::optional<std::uint64_t> environmentNumber(const char* const name)
 {
-    std::ifstream infile{"input.txt"};
+    const char* const requested{std::getenv(name)};
+    if (requested == nullptr)
+        return std::nullopt;
 
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open file!\n";
-        return -1;
-    }
+    return aoc::parseInt<std::uint64_t>(requested);
+}
 
-    Map map;
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
 
     // Load input file
 
-    std::string line;
-    while (std::getline(infile, line))
-    {
-        map.addRow(line);
-    }
+    const Cavern cavern{input};
 
-    // Main loop
+    // Setting AOC_OCTOPUS_STEPS asks for the total flashes after that many steps instead, however many it is
+    const std::optional<std::uint64_t> steps{environmentNumber("AOC_OCTOPUS_STEPS")};
 
-    int step{};
+    aoc::beginPhase("solve");
 
-    for (; map.flashesThisStep() != map.area(); ++step)
-    {
-        // Reset energy of octopuses that flashed
-        map.resetStatus();
-        
-        // Increase energy level of each octopus
+    const FlashHistory history{cavern};
 
-        for (std::size_t y{}; y < map.size(); ++y)
-        {
-            for (std::size_t x{}; x < map[y].size(); ++x)
-            {
-                ++map[y][x].energy;
-            }
-        }
+    if (steps.has_value())
+        return std::to_string(history.flashesAfter(*steps));
 
-        // Trigger flashes
+    // Steps repeat once the octopuses return to an earlier state, so if they have not all flashed at once by then
+    // they never will
 
-        while (!map.stepDone())
-        {
-            for (std::size_t y{}; y < map.size(); ++y)
-            {
-                for (std::size_t x{}; x < map[y].size(); ++x)
-                {
-                    if (map[y][x].energy > 9 && !map[y][x].flashed)
-                    {
-                        map.flash(x, y);
-                    }
-                }
-            }
-        }
+    const std::optional<std::uint64_t> step{history.firstSynchronizedStep()};
+    if (!step.has_value())
+    {
+        throw std::runtime_error{"The octopuses never all flash at once, they repeat every " +
+            std::to_string(history.cycleLength()) + " steps from step " + std::to_string(history.cycleStart())};
     }
 
-    std::cout << "Answer: " << step << '\n';
+    return std::to_string(*step);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,15 +1,20 @@
 #include <cassert>
 #include <cctype>
-#include <cstdlib>
-#include <fstream>
-#include <iostream>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "solution.hpp"
+#include "utils.hpp"
+
+namespace
+{
+
 /**
  * @brief Type representing a map of caves in a cave system
  * 
@@ -125,34 +130,32 @@ private:
     }
 };
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    // Open the input file
-    std::ifstream infile{"input.txt"};
-
-    // Terminate with error if input file could not be opened
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open input file!\n";
-        return EXIT_FAILURE;
-    }
+    aoc::beginPhase("parse");
 
     CaveMap map;
 
-    // Read each line of the input file
-    std::string line;
-    while (std::getline(infile, line))
+    // Dashes are tokens of their own, so every edge is three tokens: "to", a dash and "from"
+    const SplitView tokens{input, ByteSet{"-"}};
+    for (auto it{tokens.begin()}; it != tokens.end();)
     {
-        // Split the string on each side of the dash to get the "to" and "from" points of the edge
-        const std::size_t dashPos{line.find('-')};
-        const std::string to{line.substr(0, dashPos)};
-        const std::string from{line.substr(dashPos + 1)};
+        const std::string to{*it++};
+        if (it == tokens.end() || *it++ != "-" || it == tokens.end())
+            throw std::runtime_error{"Expected an edge between two caves after \"" + to + '"'};
+
+        const std::string from{*it++};
 
         // Add the parsed edge to the cave map
         map.addEdge(to, from);
     }
 
-    std::cout << "Answer: " << map.pathCount() << '\n';
+    aoc::beginPhase("solve");
+
+    return std::to_string(map.pathCount());
+}
+
+}
 
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,65 +1,241 @@
 #include <cassert>
 #include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
-#include <fstream>
-#include <iostream>
+#include <limits>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "solution.hpp"
+#include "threads.hpp"
+#include "utils.hpp"
+
+namespace
+{
+
+// Visited small caves are kept as bits of a std::uint64_t
+static constexpr std::size_t MAX_SMALL_CAVES{64};
+
+// Parallel searches are split until there are this many subtasks for every thread, so uneven ones even out
+static constexpr std::size_t SUBTASKS_PER_THREAD{64};
+
+/**
+ * @brief Way from one small cave to another, either directly or through a single large cave
+ *
+ */
+struct Passage
+{
+    std::size_t to{};
+
+    // Number of distinct ways, counting every large cave and every repeated edge
+    std::uint64_t weight{};
+};
+
+/**
+ * @brief Small caves only, with every large cave contracted into the passages between its neighbours
+ *
+ */
+struct SmallCaveGraph
+{
+    std::vector<std::vector<Passage>> passages;
+    std::size_t start{};
+    std::size_t end{};
+};
+
+/**
+ * @brief Where a search through a SmallCaveGraph is
+ *
+ */
+struct Visit
+{
+    std::size_t cave{};
+
+    // Bit for every small cave visited so far, including cave
+    std::uint64_t visitedSmall{};
+
+    // True if we have not already taken the extra small cave visited we're allowed
+    bool canTakeExtra{};
+};
+
+/**
+ * @brief Part of a parallel search, standing for weight paths from the start that all lead to visit
+ *
+ */
+struct Subtask
+{
+    Visit visit;
+    std::uint64_t weight{};
+};
+
+[[nodiscard]]
+static std::uint64_t checkedAdd(const std::uint64_t a, const std::uint64_t b)
+{
+    std::uint64_t result;
+    if (__builtin_add_overflow(a, b, &result))
+        throw std::overflow_error{"Path count does not fit in 64 bits"};
+
+    return result;
+}
+
+[[nodiscard]]
+static std::uint64_t checkedMultiply(const std::uint64_t a, const std::uint64_t b)
+{
+    std::uint64_t result;
+    if (__builtin_mul_overflow(a, b, &result))
+        throw std::overflow_error{"Path count does not fit in 64 bits"};
+
+    return result;
+}
+
 /**
  * @brief Type representing a map of caves in a cave system
- * 
+ *
  */
 class CaveMap
 {
 public:
     /**
      * @brief Add edge from n1 to n2 and from n2 to n1. Any caves not already registered will be added
-     * 
+     *
      * @param n1 First node of edge
      * @param fn2 Second node of edge
      */
     void addEdge(const std::string& n1, const std::string& n2)
     {
-        // Get the list of connections for n1 and n2
-        // Will insert new vectors into map if they do not already exist
-        std::vector<std::string>& connectionsN1{this->adj[n1]};
-        std::vector<std::string>& connectionsN2{this->adj[n2]};
+        const std::size_t id1{this->id(n1)};
+        const std::size_t id2{this->id(n2)};
 
         // Add connection into both lists
-        connectionsN1.push_back(n2);
-        connectionsN2.push_back(n1);
+        this->adj[id1].push_back(id2);
+        this->adj[id2].push_back(id1);
     }
 
     /**
-     * @brief Find the number of unique paths from start to end that only visit each small cave once 
-     * 
-     * @return The number of unique paths from start to end that only visit each small cave once 
+     * @brief Find the number of unique paths from start to end that visit at most one small cave other than start
+     *        and end twice, and every other small cave once. Throws std::runtime_error if there are more than
+     *        MAX_SMALL_CAVES small caves or two large caves are connected, and std::overflow_error if the count does
+     *        not fit in 64 bits
+     *
+     * @return The number of unique paths
      */
-    int pathCount() const
+    [[nodiscard]]
+    std::uint64_t pathCount() const
     {
-        // The number of paths found
-        int count{};
+        const SmallCaveGraph graph{this->contract()};
 
-        // Set of small caves that have already been visited
-        std::unordered_set<std::string> visitedSmall{"start"};
+        // Paths counted from each cave, visited set and whether the extra visit is left, filled in as they are found
+        std::vector<std::unordered_map<std::uint64_t, std::uint64_t>> memo(graph.passages.size() * 2);
 
-        // Find all paths recursivly
-        pathCount("start", true, count, visitedSmall);
+        return pathCount(graph, {graph.start, std::uint64_t{1} << graph.start, true}, memo);
+    }
+
+    /**
+     * @brief Same count as pathCount without memoization, for cave systems whose visited sets rarely repeat
+     *        The first levels of the search are split into subtasks, which threads of pool take one at a time as they
+     *        free up, each searching with its own visited set and count
+     *
+     * @param pool
+     * @return The number of unique paths
+     */
+    [[nodiscard]]
+    std::uint64_t parallelPathCount(aoc::ThreadPool& pool) const
+    {
+        const SmallCaveGraph graph{this->contract()};
+
+        // Paths that reach the end while the search is being split
+        std::uint64_t count{};
+
+        std::vector<Subtask> subtasks{{{graph.start, std::uint64_t{1} << graph.start, true}, 1}};
+        while (!subtasks.empty() && subtasks.size() < pool.size() * SUBTASKS_PER_THREAD)
+        {
+            std::vector<Subtask> deeper;
+            for (const Subtask& subtask : subtasks)
+            {
+                for (const Passage& passage : graph.passages[subtask.visit.cave])
+                {
+                    const std::optional<Visit> next{follow(graph, subtask.visit, passage.to)};
+                    if (!next)
+                        continue;
+
+                    const std::uint64_t weight{checkedMultiply(subtask.weight, passage.weight)};
+                    if (next->cave == graph.end)
+                        count = checkedAdd(count, weight);
+                    else
+                        deeper.push_back({*next, weight});
+                }
+            }
+
+            subtasks = std::move(deeper);
+        }
+
+        std::vector<std::uint64_t> counts(subtasks.size());
+        pool.parallelFor(subtasks.size(), [&graph, &subtasks, &counts](const std::size_t i) -> void
+        {
+            counts[i] = checkedMultiply(subtasks[i].weight, enumeratedPathCount(graph, subtasks[i].visit));
+        });
+
+        for (const std::uint64_t subtaskCount : counts)
+        {
+            count = checkedAdd(count, subtaskCount);
+        }
 
         return count;
     }
 private:
+    // Names of each cave by id, and the id of each name
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::size_t> ids;
+
+    // Whether each cave is small, worked out once when it is added
+    std::vector<bool> small;
+
     // Adjacency list storing a graph
-    std::unordered_map<std::string, std::vector<std::string>> adj;
+    std::vector<std::vector<std::size_t>> adj;
+
+    /**
+     * @brief Id of the cave name, adding it if it is new
+     *
+     * @param name
+     * @return std::size_t
+     */
+    std::size_t id(const std::string& name)
+    {
+        const auto[it, inserted]{this->ids.try_emplace(name, this->names.size())};
+        if (inserted)
+        {
+            this->names.push_back(name);
+            this->small.push_back(caveIsSmall(name));
+            this->adj.emplace_back();
+        }
+
+        return it->second;
+    }
+
+    /**
+     * @brief Id of the cave name, which must already be on the map or std::runtime_error will be thrown
+     *
+     * @param name
+     * @return std::size_t
+     */
+    [[nodiscard]]
+    std::size_t existingId(const std::string& name) const
+    {
+        const auto it{this->ids.find(name)};
+        if (it == this->ids.end())
+            throw std::runtime_error{"No cave named " + name};
+
+        return it->second;
+    }
 
     /**
      * @brief Check if cave name is for a small cave (all lowercase). Assert will be called to check against mixed case
-     * 
+     *
      * @param name Name of cave to check
      * @return true if cave is small, else false
      */
@@ -87,84 +263,210 @@ private:
     }
 
     /**
-     * @brief Recursive function to calculate the number of unique paths through the cave system that only visit each small cave once
-     * 
-     * @param currentCave The cave currently being visited
-     * @param canTakeExtra True if we have not already taken the extra small cave visited we're allowed
-     * @param count Reference to a value storing the number of paths discovered so far
-     * @param visitedSmall Set of all small caves visited so far
+     * @brief Number the small caves densely and replace every large cave with passages between each pair of its
+     *        neighbours, including from a neighbour back to itself. Two connected large caves would allow endless
+     *        paths, so std::runtime_error is thrown for them
+     *
+     * @return SmallCaveGraph
      */
-    void pathCount(const std::string& currentCave, const bool canTakeExtra, int& count, std::unordered_set<std::string>& visitedSmall) const
+    [[nodiscard]]
+    SmallCaveGraph contract() const
     {
-        // Path discovered
-        if (currentCave == "end")
+        constexpr std::size_t LARGE{std::numeric_limits<std::size_t>::max()};
+
+        // Dense number of each small cave, or LARGE
+        std::vector<std::size_t> numbers(this->names.size(), LARGE);
+        std::size_t smallCount{};
+
+        for (std::size_t cave{}; cave < this->names.size(); ++cave)
         {
-            ++count;
+            if (this->small[cave])
+                numbers[cave] = smallCount++;
         }
-        else
+
+        if (smallCount > MAX_SMALL_CAVES)
         {
-            const std::vector<std::string>& connections{this->adj.at(currentCave)};
+            throw std::runtime_error{"At most " + std::to_string(MAX_SMALL_CAVES) + " small caves are supported, not " +
+                std::to_string(smallCount)};
+        }
 
-            // Explore all caves (except visited small caves) that connect to current
-            for (const std::string& cave : connections)
+        // Weight of the passage between each pair of small caves
+        std::vector<std::uint64_t> weights(smallCount * smallCount);
+
+        for (std::size_t cave{}; cave < this->names.size(); ++cave)
+        {
+            if (this->small[cave])
             {
-                const bool optionIsSmall{caveIsSmall(cave)};
+                for (const std::size_t next : this->adj[cave])
+                {
+                    if (this->small[next])
+                        ++weights[numbers[cave] * smallCount + numbers[next]];
+                }
 
-                if (optionIsSmall)
+                continue;
+            }
+
+            for (const std::size_t from : this->adj[cave])
+            {
+                if (!this->small[from])
                 {
-                    // If option is small, only travel if it's either unvisited or we have not already taken our extra small cave
-                    if (visitedSmall.contains(cave))
-                    {
-                        // If we can take an extra small cave, make sure it's not start or end first then travel, making sure to pass false
-                        if (canTakeExtra && cave != "start" && cave != "end")
-                            pathCount(cave, false, count, visitedSmall);
-                    }
-                    else
-                    {
-                        // Mark visited and unvisited only if option is NOT our extra small cave take
-                        visitedSmall.insert(cave);
-                        pathCount(cave, canTakeExtra, count, visitedSmall);
-                        visitedSmall.erase(cave);
-                    }
+                    throw std::runtime_error{"Large caves " + this->names[cave] + " and " + this->names[from] +
+                        " are connected, so there are endless paths"};
                 }
-                else
+
+                for (const std::size_t to : this->adj[cave])
                 {
-                    // If option is large, always travel
-                    pathCount(cave, canTakeExtra, count, visitedSmall);
+                    ++weights[numbers[from] * smallCount + numbers[to]];
                 }
             }
         }
+
+        SmallCaveGraph graph{std::vector<std::vector<Passage>>(smallCount), numbers[this->existingId("start")],
+            numbers[this->existingId("end")]};
+
+        for (std::size_t from{}; from < smallCount; ++from)
+        {
+            for (std::size_t to{}; to < smallCount; ++to)
+            {
+                if (weights[from * smallCount + to] != 0)
+                    graph.passages[from].push_back({to, weights[from * smallCount + to]});
+            }
+        }
+
+        return graph;
     }
-};
 
-int main()
-{
-    // Open the input file
-    std::ifstream infile{"input.txt"};
+    /**
+     * @brief Where the search is after moving from visit to the small cave to, or nothing if to may not be visited
+     *
+     * @param graph
+     * @param visit
+     * @param to
+     * @return std::optional<Visit>
+     */
+    [[nodiscard]]
+    static std::optional<Visit> follow(const SmallCaveGraph& graph, const Visit& visit, const std::size_t to) noexcept
+    {
+        const std::uint64_t bit{std::uint64_t{1} << to};
+        if ((visit.visitedSmall & bit) == 0)
+            return Visit{to, visit.visitedSmall | bit, visit.canTakeExtra};
+
+        // If we can take an extra small cave, make sure it's not start or end first then travel, passing false
+        if (visit.canTakeExtra && to != graph.start && to != graph.end)
+            return Visit{to, visit.visitedSmall, false};
 
-    // Terminate with error if input file could not be opened
-    if (!infile.is_open())
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Recursive function to calculate the number of unique paths from visit to the end of graph
+     *
+     * @param graph Contracted cave system
+     * @param visit Where the search currently is
+     * @param memo Paths already counted, by cave and canTakeExtra then visitedSmall
+     * @return std::uint64_t
+     */
+    [[nodiscard]]
+    static std::uint64_t pathCount(const SmallCaveGraph& graph, const Visit& visit,
+        std::vector<std::unordered_map<std::uint64_t, std::uint64_t>>& memo)
     {
-        std::cerr << "ERROR! Could not open input file!\n";
-        return EXIT_FAILURE;
+        // Path discovered
+        if (visit.cave == graph.end)
+            return 1;
+
+        std::unordered_map<std::uint64_t, std::uint64_t>& known{memo[visit.cave * 2 + (visit.canTakeExtra ? 1 : 0)]};
+        if (const auto it{known.find(visit.visitedSmall)}; it != known.end())
+            return it->second;
+
+        std::uint64_t count{};
+
+        // Explore all caves (except visited small caves) that connect to current
+        for (const Passage& passage : graph.passages[visit.cave])
+        {
+            if (const std::optional<Visit> next{follow(graph, visit, passage.to)})
+                count = checkedAdd(count, checkedMultiply(passage.weight, pathCount(graph, *next, memo)));
+        }
+
+        known.emplace(visit.visitedSmall, count);
+
+        return count;
     }
 
+    /**
+     * @brief Recursive function to calculate the number of unique paths from visit to the end of graph, visiting
+     *        every one of them
+     *
+     * @param graph Contracted cave system
+     * @param visit Where the search currently is
+     * @return std::uint64_t
+     */
+    [[nodiscard]]
+    static std::uint64_t enumeratedPathCount(const SmallCaveGraph& graph, const Visit& visit)
+    {
+        // Path discovered
+        if (visit.cave == graph.end)
+            return 1;
+
+        std::uint64_t count{};
+
+        for (const Passage& passage : graph.passages[visit.cave])
+        {
+            if (const std::optional<Visit> next{follow(graph, visit, passage.to)})
+                count = checkedAdd(count, checkedMultiply(passage.weight, enumeratedPathCount(graph, *next)));
+        }
+
+        return count;
+    }
+};
+
+/**
+ * @brief Number of paths through map using the search named by the AOC_CAVE_SEARCH environment variable: "memo" to
+ *        memoize on the visited set, or "parallel" to enumerate every path across the shared thread pool
+ *        Memoization is used when it is not set. std::runtime_error will be thrown for any other name
+ *
+ * @param map
+ * @return std::uint64_t
+ */
+[[nodiscard]]
+static std::uint64_t pathCount(const CaveMap& map)
+{
+    const char* const requested{std::getenv("AOC_CAVE_SEARCH")};
+    const std::string_view search{requested == nullptr ? "memo" : requested};
+
+    if (search == "memo")
+        return map.pathCount();
+    if (search == "parallel")
+        return map.parallelPathCount(aoc::threadPool());
+
+    throw std::runtime_error{"Unknown search \"" + std::string{search} + "\", expected memo or parallel"};
+}
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
     CaveMap map;
 
-    // Read each line of the input file
-    std::string line;
-    while (std::getline(infile, line))
+    // Dashes are tokens of their own, so every edge is three tokens: "to", a dash and "from"
+    const SplitView tokens{input, ByteSet{"-"}};
+    for (auto it{tokens.begin()}; it != tokens.end();)
     {
-        // Split the string on each side of the dash to get the "to" and "from" points of the edge
-        const std::size_t dashPos{line.find('-')};
-        const std::string to{line.substr(0, dashPos)};
-        const std::string from{line.substr(dashPos + 1)};
+        const std::string to{*it++};
+        if (it == tokens.end() || *it++ != "-" || it == tokens.end())
+            throw std::runtime_error{"Expected an edge between two caves after \"" + to + '"'};
+
+        const std::string from{*it++};
 
         // Add the parsed edge to the cave map
         map.addEdge(to, from);
     }
 
-    std::cout << "Answer: " << map.pathCount() << '\n';
+    aoc::beginPhase("solve");
+
+    return std::to_string(pathCount(map));
+}
+
+}
 
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
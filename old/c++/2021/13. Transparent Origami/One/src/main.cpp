@@ -1,29 +1,18 @@
+#include <algorithm>
+#include <bit>
 #include <cstddef>
-#include <fstream>
-#include <functional>
-#include <iostream>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
-#include <unordered_set>
+#include <vector>
 
-struct Point
-{
-    std::size_t x{};
-    std::size_t y{};
-
-    constexpr bool operator==(const Point& rhs) const = default;
-};
+#include "parse.hpp"
+#include "solution.hpp"
 
-template<>
-struct std::hash<Point>
+namespace
 {
-    std::size_t operator()(const Point& point) const noexcept
-    {
-        const std::hash<std::size_t> func;
-        const std::size_t xHash{func(point.x)};
-        const std::size_t yHash{func(point.y)};
-        return xHash ^ (yHash << 1);
-    }
-};
 
 enum class Along
 {
@@ -35,119 +24,179 @@ enum class Along
 static constexpr std::string_view FOLD_PROMPT{"fold along "};
 
 /**
- * @brief Fold along the X axis
- * 
- * @param points Paper to fold
- * @param line Point to fold along
- * @return Folded version of the paper
+ * @brief Dots on transparent paper, a bit for every position packed row by row into 64 bit words
+ *        Folds OR one half into the other without allocating, and the folded away half is simply no longer looked at.
+ *        Rows keep their words after folding left, so folding up stays a word by word OR of whole rows
+ *
  */
-static std::unordered_set<Point> foldX(const std::unordered_set<Point>& points, const std::size_t line)
+class Paper
 {
-    std::unordered_set<Point> result;
+public:
+    Paper(const std::size_t a_width, const std::size_t a_height) :
+        width{a_width}, height{a_height}, rowWords{(a_width + 63) / 64}, words(rowWords * a_height) {}
 
-    for (const Point& point : points)
+    void set(const std::size_t x, const std::size_t y) noexcept
     {
-        if (point.x < line)
-            result.insert(point);
+        this->words[y * this->rowWords + x / 64] |= std::uint64_t{1} << (x % 64);
+    }
+
+    /**
+     * @brief Fold along the specified axis. Dots on the line itself are lost, and folding past the far edge throws
+     *        std::runtime_error
+     *
+     * @param line Position to fold along
+     * @param along Direction to fold along
+     */
+    void fold(const std::size_t line, const Along along)
+    {
+        if (along == Along::X)
+            this->foldLeft(line);
         else
-            result.emplace(line - (point.x - line), point.y);
+            this->foldUp(line);
     }
 
-    return result;
-}
+    [[nodiscard]]
+    std::size_t dotCount() const noexcept
+    {
+        // Nothing is left past the width, and rows past the height are not looked at
+        std::size_t result{};
+        for (const std::uint64_t word : std::span{this->words}.first(this->height * this->rowWords))
+        {
+            result += static_cast<std::size_t>(std::popcount(word));
+        }
+
+        return result;
+    }
 
-/**
- * @brief Fold along the Y axis
- * 
- * @param points Paper to fold
- * @param line Point to fold along
- * @return Folded version of the paper
- */
-static std::unordered_set<Point> foldY(const std::unordered_set<Point>& points, const std::size_t line)
-{
-    std::unordered_set<Point> result;
+private:
+    std::size_t width;
+    std::size_t height;
 
-    for (const Point& point : points)
+    std::size_t rowWords;
+    std::vector<std::uint64_t> words;
+
+    [[nodiscard]]
+    std::span<std::uint64_t> row(const std::size_t y) noexcept
     {
-        if (point.y < line)
-            result.insert(point);
-        else
-            result.emplace(point.x, line - (point.y - line));
+        return std::span{this->words}.subspan(y * this->rowWords, this->rowWords);
     }
 
-    return result;
-}
-
-/**
- * @brief Fold along the specified axis
- * 
- * @param points Paper to fold
- * @param line Point to fold along
- * @param along Direction to fold along
- * @return Folded version of the paper
- */
-static std::unordered_set<Point> fold(const std::unordered_set<Point>& points, const std::size_t line, const Along along)
-{
-    if (along == Along::X)
-        return foldX(points, line);
-    else
-        return foldY(points, line);
-}
+    [[nodiscard]]
+    std::span<const std::uint64_t> row(const std::size_t y) const noexcept
+    {
+        return std::span{this->words}.subspan(y * this->rowWords, this->rowWords);
+    }
 
-int main()
-{
-    std::ifstream infile{"input.txt"};
+    /**
+     * @brief Fold the rows below line up over the rows above it, a word at a time
+     *
+     * @param line
+     */
+    void foldUp(const std::size_t line)
+    {
+        if (line >= this->height)
+            return;
+        if (this->height - 1 - line > line)
+            throw std::runtime_error{"Can not fold up past the top of the paper"};
+
+        for (std::size_t y{line + 1}; y < this->height; ++y)
+        {
+            const std::span<std::uint64_t> above{this->row(2 * line - y)};
+            std::ranges::transform(this->row(y), above, above.begin(), std::bit_or{});
+        }
+
+        this->height = line;
+    }
 
-    if (!infile.is_open())
+    /**
+     * @brief Fold the columns right of line over the columns left of it. Only the dots on the right are visited
+     *
+     * @param line
+     */
+    void foldLeft(const std::size_t line)
     {
-        std::cerr << "ERROR! Could not open input file!\n";
-        return 1;
+        if (line >= this->width)
+            return;
+        if (this->width - 1 - line > line)
+            throw std::runtime_error{"Can not fold left past the left edge of the paper"};
+
+        // Bits of the words holding line and everything right of it that are left of line
+        const std::size_t firstWord{line / 64};
+        const std::uint64_t keptBits{(std::uint64_t{1} << (line % 64)) - 1};
+
+        for (std::size_t y{}; y < this->height; ++y)
+        {
+            const std::span<std::uint64_t> bits{this->row(y)};
+
+            for (std::size_t i{firstWord}; i < this->rowWords; ++i)
+            {
+                // Dots from line on, which are cleared as they are moved
+                std::uint64_t moved{i == firstWord ? bits[i] & ~keptBits : bits[i]};
+                bits[i] &= i == firstWord ? keptBits : 0;
+
+                for (; moved != 0; moved &= moved - 1)
+                {
+                    const std::size_t x{i * 64 + static_cast<std::size_t>(std::countr_zero(moved))};
+                    if (x != line)
+                        bits[(2 * line - x) / 64] |= std::uint64_t{1} << ((2 * line - x) % 64);
+                }
+            }
+        }
+
+        this->width = line;
     }
+};
 
-    // Store points currently on the paper as a set
-    std::unordered_set<Point> points;
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    // Points and folds are separated by an empty breakpoint line
+    const std::size_t breakpoint{input.find("\n\n")};
+    if (breakpoint == std::string_view::npos)
+        throw std::runtime_error{"Expected an empty line between points and folds"};
 
-    std::size_t x;
-    std::size_t y;
+    // Read points, which are pairs of x and y
+    const std::vector<std::size_t> coordinates{aoc::parseInts<std::size_t>(input.substr(0, breakpoint))};
 
-    // Read points until the breakpoint
-    while (infile.peek() != '\n')
+    // Paper is just big enough for every point
+    std::size_t width{};
+    std::size_t height{};
+    for (std::size_t i{0}; i + 1 < coordinates.size(); i += 2)
     {
-        infile >> x;
-        // Ignore comma
-        infile.ignore();
-        infile >> y;
-        points.emplace(x, y);
-
-        // Ignore newline
-        infile.ignore();
+        width = std::max(width, coordinates[i] + 1);
+        height = std::max(height, coordinates[i + 1] + 1);
     }
-    // Ignore empty breakpoint line
-    infile.ignore();
 
-    // Read folds until the first character isn't the 'f' in 'fold'
-    while (infile.peek() == FOLD_PROMPT.front())
+    Paper paper{width, height};
+    for (std::size_t i{0}; i + 1 < coordinates.size(); i += 2)
     {
-        // Ignore entire promt string
-        infile.ignore(FOLD_PROMPT.size());
+        paper.set(coordinates[i], coordinates[i + 1]);
+    }
 
-        const char axis{static_cast<char>(infile.get())};
-        // Ignore equals
-        infile.ignore();
+    aoc::beginPhase("solve");
+
+    // Read folds until a line doesn't start with the promt
+    for (const std::string_view instruction : aoc::lines(input.substr(breakpoint + 2)))
+    {
+        if (!instruction.starts_with(FOLD_PROMPT) || instruction.size() < FOLD_PROMPT.size() + 2)
+            break;
 
-        std::size_t line;
-        infile >> line;
-        // Ignore newline
-        infile.ignore();
+        // Axis follows the promt, then an equals and the line to fold along
+        const char axis{instruction[FOLD_PROMPT.size()]};
+        const std::size_t line{aoc::parseInt<std::size_t>(instruction.substr(FOLD_PROMPT.size() + 2))};
 
         // Preform fold
-        points = fold(points, line, axis == 'x' ? Along::X : Along::Y);
-        
+        paper.fold(line, axis == 'x' ? Along::X : Along::Y);
+
         // Only one fold for part one
         break;
     }
 
-    std::cout << "Result: " << points.size() << '\n';
+    return std::to_string(paper.dotCount());
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
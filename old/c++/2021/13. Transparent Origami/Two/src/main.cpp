@@ -1,24 +1,19 @@
 #include <algorithm>
+#include <bit>
 #include <cstddef>
-#include <fstream>
-#include <functional>
-#include <iostream>
+#include <cstdint>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <string_view>
-#include <set>
+#include <vector>
 
-struct Point
-{
-    std::size_t x{};
-    std::size_t y{};
+#include "parse.hpp"
+#include "solution.hpp"
 
-    constexpr bool operator<(const Point& rhs) const noexcept
-    {
-        if (this->y == rhs.y)
-            return this->x < rhs.x;
-        else
-            return this->y < rhs.y;
-    }
-};
+namespace
+{
 
 enum class Along
 {
@@ -30,158 +25,233 @@ enum class Along
 static constexpr std::string_view FOLD_PROMPT{"fold along "};
 
 /**
- * @brief Fold along the X axis
- * 
- * @param points Paper to fold
- * @param line Point to fold along
- * @return Folded version of the paper
+ * @brief Dots on transparent paper, a bit for every position packed row by row into 64 bit words
+ *        Folds OR one half into the other without allocating, and the folded away half is simply no longer looked at.
+ *        Rows keep their words after folding left, so folding up stays a word by word OR of whole rows
+ *
  */
-static std::set<Point> foldX(const std::set<Point>& points, const std::size_t line)
+class Paper
 {
-    std::set<Point> result;
+public:
+    Paper(const std::size_t a_width, const std::size_t a_height) :
+        width{a_width}, height{a_height}, rowWords{(a_width + 63) / 64}, words(rowWords * a_height) {}
 
-    for (const Point& point : points)
+    void set(const std::size_t x, const std::size_t y) noexcept
     {
-        if (point.x < line)
-            result.insert(point);
-        else
-            result.emplace(line - (point.x - line), point.y);
+        this->words[y * this->rowWords + x / 64] |= std::uint64_t{1} << (x % 64);
     }
 
-    return result;
-}
-
-/**
- * @brief Fold along the Y axis
- * 
- * @param points Paper to fold
- * @param line Point to fold along
- * @return Folded version of the paper
- */
-static std::set<Point> foldY(const std::set<Point>& points, const std::size_t line)
-{
-    std::set<Point> result;
-
-    for (const Point& point : points)
+    /**
+     * @brief Fold along the specified axis. Dots on the line itself are lost, and folding past the far edge throws
+     *        std::runtime_error
+     *
+     * @param line Position to fold along
+     * @param along Direction to fold along
+     */
+    void fold(const std::size_t line, const Along along)
     {
-        if (point.y < line)
-            result.insert(point);
+        if (along == Along::X)
+            this->foldLeft(line);
         else
-            result.emplace(point.x, line - (point.y - line));
+            this->foldUp(line);
     }
 
-    return result;
-}
+    /**
+     * @brief Print paper to a stream from the top left corner to the last dot, as wide as the rightmost dot
+     *        The last line is left unterminated
+     *
+     * @param out Stream to print to
+     */
+    void render(std::ostream& out) const
+    {
+        // Every row ORed together has a bit for every column that holds a dot
+        std::vector<std::uint64_t> columns(this->rowWords);
+        std::size_t lastRow{};
+        bool empty{true};
 
-/**
- * @brief Fold along the specified axis
- * 
- * @param points Paper to fold
- * @param line Point to fold along
- * @param along Direction to fold along
- * @return Folded version of the paper
- */
-static std::set<Point> fold(const std::set<Point>& points, const std::size_t line, const Along along)
-{
-    if (along == Along::X)
-        return foldX(points, line);
-    else
-        return foldY(points, line);
-}
+        for (std::size_t y{}; y < this->height; ++y)
+        {
+            const std::span<const std::uint64_t> bits{this->row(y)};
+            for (std::size_t i{}; i < this->rowWords; ++i)
+            {
+                columns[i] |= bits[i];
+                if (bits[i] != 0)
+                {
+                    lastRow = y;
+                    empty = false;
+                }
+            }
+        }
 
-/**
- * @brief Print paper to stdout
- * 
- * @param points Paper to print
- */
-static void render(const std::set<Point>& points)
-{
-    // Find X largest X coord from points to use as width
-    const std::size_t width{std::ranges::max_element(points, {}, &Point::x)->x + 1};
+        if (empty)
+            return;
 
-    // Position to contiune from
-    Point last;
+        const std::size_t columnCount{usedWidth(columns)};
+        for (std::size_t y{}; y < lastRow; ++y)
+        {
+            this->renderRow(out, y, columnCount);
+            out << '\n';
+        }
+
+        // Stop at the last dot
+        this->renderRow(out, lastRow, usedWidth(this->row(lastRow)));
+    }
+private:
+    std::size_t width;
+    std::size_t height;
+
+    std::size_t rowWords;
+    std::vector<std::uint64_t> words;
 
-    for (const Point& point : points)
+    [[nodiscard]]
+    std::span<std::uint64_t> row(const std::size_t y) noexcept
     {
-        // If we need to move down, finish the current line and print empty lines we need to skip
-        for (; last.y < point.y; ++last.y)
+        return std::span{this->words}.subspan(y * this->rowWords, this->rowWords);
+    }
+
+    [[nodiscard]]
+    std::span<const std::uint64_t> row(const std::size_t y) const noexcept
+    {
+        return std::span{this->words}.subspan(y * this->rowWords, this->rowWords);
+    }
+
+    /**
+     * @brief Columns up to and including the last set bit of bits
+     *
+     * @param bits
+     * @return std::size_t
+     */
+    [[nodiscard]]
+    static std::size_t usedWidth(const std::span<const std::uint64_t> bits) noexcept
+    {
+        for (std::size_t i{bits.size()}; i > 0; --i)
         {
-            for (; last.x < width; ++last.x)
-            {
-                std::cout << '.';
-            }
-            std::cout << '\n';
+            if (bits[i - 1] != 0)
+                return i * 64 - static_cast<std::size_t>(std::countl_zero(bits[i - 1]));
+        }
 
-            // Reset to start of line after finishing a line
-            last.x = 0;
+        return 0;
+    }
+
+    void renderRow(std::ostream& out, const std::size_t y, const std::size_t columns) const
+    {
+        const std::span<const std::uint64_t> bits{this->row(y)};
+        for (std::size_t x{}; x < columns; ++x)
+        {
+            out << ((bits[x / 64] >> (x % 64) & 1) != 0 ? '#' : '.');
         }
+    }
+
+    /**
+     * @brief Fold the rows below line up over the rows above it, a word at a time
+     *
+     * @param line
+     */
+    void foldUp(const std::size_t line)
+    {
+        if (line >= this->height)
+            return;
+        if (this->height - 1 - line > line)
+            throw std::runtime_error{"Can not fold up past the top of the paper"};
 
-        // Print portion of line before point
-        for (; last.x < point.x; ++last.x)
+        for (std::size_t y{line + 1}; y < this->height; ++y)
         {
-            std::cout << '.';
+            const std::span<std::uint64_t> above{this->row(2 * line - y)};
+            std::ranges::transform(this->row(y), above, above.begin(), std::bit_or{});
         }
 
-        // Print point
-        std::cout << '#';
-        ++last.x;
+        this->height = line;
     }
-    std::cout << '\n';
-}
 
-int main()
-{
-    std::ifstream infile{"input.txt"};
-
-    if (!infile.is_open())
+    /**
+     * @brief Fold the columns right of line over the columns left of it. Only the dots on the right are visited
+     *
+     * @param line
+     */
+    void foldLeft(const std::size_t line)
     {
-        std::cerr << "ERROR! Could not open input file!\n";
-        return 1;
+        if (line >= this->width)
+            return;
+        if (this->width - 1 - line > line)
+            throw std::runtime_error{"Can not fold left past the left edge of the paper"};
+
+        // Bits of the words holding line and everything right of it that are left of line
+        const std::size_t firstWord{line / 64};
+        const std::uint64_t keptBits{(std::uint64_t{1} << (line % 64)) - 1};
+
+        for (std::size_t y{}; y < this->height; ++y)
+        {
+            const std::span<std::uint64_t> bits{this->row(y)};
+
+            for (std::size_t i{firstWord}; i < this->rowWords; ++i)
+            {
+                // Dots from line on, which are cleared as they are moved
+                std::uint64_t moved{i == firstWord ? bits[i] & ~keptBits : bits[i]};
+                bits[i] &= i == firstWord ? keptBits : 0;
+
+                for (; moved != 0; moved &= moved - 1)
+                {
+                    const std::size_t x{i * 64 + static_cast<std::size_t>(std::countr_zero(moved))};
+                    if (x != line)
+                        bits[(2 * line - x) / 64] |= std::uint64_t{1} << ((2 * line - x) % 64);
+                }
+            }
+        }
+
+        this->width = line;
     }
+};
 
-    // Store points currently on the paper as a set. Ordered for rendering later
-    std::set<Point> points;
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
 
-    std::size_t x;
-    std::size_t y;
+    // Points and folds are separated by an empty breakpoint line
+    const std::size_t breakpoint{input.find("\n\n")};
+    if (breakpoint == std::string_view::npos)
+        throw std::runtime_error{"Expected an empty line between points and folds"};
 
-    // Read points until the breakpoint
-    while (infile.peek() != '\n')
+    // Read points, which are pairs of x and y
+    const std::vector<std::size_t> coordinates{aoc::parseInts<std::size_t>(input.substr(0, breakpoint))};
+
+    // Paper is just big enough for every point
+    std::size_t width{};
+    std::size_t height{};
+    for (std::size_t i{0}; i + 1 < coordinates.size(); i += 2)
     {
-        infile >> x;
-        // Ignore comma
-        infile.ignore();
-        infile >> y;
-        points.emplace(x, y);
-
-        // Ignore newline
-        infile.ignore();
+        width = std::max(width, coordinates[i] + 1);
+        height = std::max(height, coordinates[i + 1] + 1);
     }
-    // Ignore empty breakpoint line
-    infile.ignore();
 
-    // Read folds until the first character isn't the 'f' in 'fold'
-    while (infile.peek() == FOLD_PROMPT.front())
+    Paper paper{width, height};
+    for (std::size_t i{0}; i + 1 < coordinates.size(); i += 2)
     {
-        // Ignore entire promt string
-        infile.ignore(FOLD_PROMPT.size());
+        paper.set(coordinates[i], coordinates[i + 1]);
+    }
 
-        const char axis{static_cast<char>(infile.get())};
-        // Ignore equals
-        infile.ignore();
+    aoc::beginPhase("solve");
+
+    // Read folds until a line doesn't start with the promt
+    for (const std::string_view instruction : aoc::lines(input.substr(breakpoint + 2)))
+    {
+        if (!instruction.starts_with(FOLD_PROMPT) || instruction.size() < FOLD_PROMPT.size() + 2)
+            break;
 
-        std::size_t line;
-        infile >> line;
-        // Ignore newline
-        infile.ignore();
+        // Axis follows the promt, then an equals and the line to fold along
+        const char axis{instruction[FOLD_PROMPT.size()]};
+        const std::size_t line{aoc::parseInt<std::size_t>(instruction.substr(FOLD_PROMPT.size() + 2))};
 
         // Preform fold
-        points = fold(points, line, axis == 'x' ? Along::X : Along::Y);
+        paper.fold(line, axis == 'x' ? Along::X : Along::Y);
     }
 
-    std::cout << "Result:\n";
-    render(points);
+    std::ostringstream result;
+    paper.render(result);
+
+    return result.str();
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
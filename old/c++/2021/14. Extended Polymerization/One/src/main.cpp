@@ -1,15 +1,19 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
-#include <fstream>
 #include <functional>
-#include <iostream>
 #include <iterator>
 #include <limits>
 #include <list>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
+#include "solution.hpp"
+
+namespace
+{
+
 struct RuleMatch
 {
     char left{};
@@ -18,8 +22,7 @@ struct RuleMatch
     constexpr bool operator==(const RuleMatch& rhs) const noexcept = default;
 };
 
-template<>
-struct std::hash<RuleMatch>
+struct RuleMatchHash
 {
     std::size_t operator()(const RuleMatch ruleMatch) const noexcept
     {
@@ -38,7 +41,7 @@ struct std::hash<RuleMatch>
  * @param infile File to read from
  * @return Starting polymer value
  */
-static std::list<char> readStartingPolymer(std::ifstream& infile)
+static std::list<char> readStartingPolymer(std::istream& infile)
 {
     std::list<char> polymer;
 
@@ -56,9 +59,9 @@ static std::list<char> readStartingPolymer(std::ifstream& infile)
  * @param infile File to read from
  * @return std::unordered_map of rules to character to insert
  */
-static std::unordered_map<RuleMatch, char> readRules(std::ifstream& infile)
+static std::unordered_map<RuleMatch, char, RuleMatchHash> readRules(std::istream& infile)
 {
-    std::unordered_map<RuleMatch, char> rules;
+    std::unordered_map<RuleMatch, char, RuleMatchHash> rules;
 
     char left;
     char right;
@@ -83,7 +86,7 @@ static std::unordered_map<RuleMatch, char> readRules(std::ifstream& infile)
  * @param polymer Polyer to insert into
  * @param rules Insertion rules
  */
-static void insertionStep(std::list<char>& polymer, const std::unordered_map<RuleMatch, char>& rules)
+static void insertionStep(std::list<char>& polymer, const std::unordered_map<RuleMatch, char, RuleMatchHash>& rules)
 {
     for (auto it{polymer.begin()}; it != std::prev(polymer.end()); ++it)
     {
@@ -94,24 +97,23 @@ static void insertionStep(std::list<char>& polymer, const std::unordered_map<Rul
     }
 }
 
-int main()
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
     static constexpr int STEP_COUNT{10};
 
-    std::ifstream infile{"input.txt"};
+    aoc::beginPhase("parse");
 
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open infile!\n";
-        return 1;
-    }
+    aoc::InputStream infile{input};
 
     std::list<char> polymer{readStartingPolymer(infile)};
 
     // Ignore emtpy line
     infile.ignore();
 
-    std::unordered_map<RuleMatch, char> rules{readRules(infile)};
+    std::unordered_map<RuleMatch, char, RuleMatchHash> rules{readRules(infile)};
+
+    aoc::beginPhase("solve");
 
     for (int i{}; i < STEP_COUNT; ++i)
     {
@@ -136,7 +138,9 @@ int main()
 
     const std::size_t minValue{*std::ranges::min_element(counts)};
 
-    std::cout << "Result: " << maxValue - minValue << '\n';
+    return std::to_string(maxValue - minValue);
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,18 +1,43 @@
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <cmath>
+#include <compare>
 #include <cstddef>
-#include <fstream>
-#include <functional>
-#include <iostream>
-#include <iterator>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
 #include <limits>
-#include <numeric>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "parse.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
+// Steps to run unless the AOC_POLYMER_STEPS environment variable says otherwise
+static constexpr std::uint64_t STEP_COUNT{40};
+
+static constexpr std::size_t LETTER_COUNT{26};
+
+// Holds exact counts for up to about 120 steps
+__extension__ using Count = unsigned __int128;
+
+// Most and least common letters are picked from exact counts for up to this many steps, and from logarithms beyond
+static constexpr std::uint64_t EXACT_STEP_LIMIT{4096};
+
+// Logarithms closer than this relative to their size might be out of order. Rounding errors grow with the size of the
+// state and the bits of the steps, and stay orders of magnitude below this
+static constexpr double LOG_TIE_TOLERANCE{1e-9};
+
 /**
  * @brief Insertion rule to insert 'between' between 'left' and 'right'
- * 
+ *
  */
 struct InsertionRule
 {
@@ -21,109 +46,506 @@ struct InsertionRule
     char between{};
 };
 
-class Polymer
+/**
+ * @brief Exact counts. std::overflow_error will be thrown as soon as one does not fit in a Count
+ *
+ */
+struct ExactArithmetic
+{
+    using Value = Count;
+
+    [[nodiscard]]
+    Value from(const std::uint64_t count) const noexcept
+    {
+        return count;
+    }
+
+    [[nodiscard]]
+    Value add(const Value a, const Value b) const
+    {
+        Value result;
+        if (__builtin_add_overflow(a, b, &result))
+            throw std::overflow_error{"Counts do not fit in 128 bits"};
+
+        return result;
+    }
+
+    [[nodiscard]]
+    Value multiply(const Value a, const Value b) const
+    {
+        Value result;
+        if (__builtin_mul_overflow(a, b, &result))
+            throw std::overflow_error{"Counts do not fit in 128 bits"};
+
+        return result;
+    }
+};
+
+/**
+ * @brief Counts modulo modulus, which must not be 0
+ *
+ */
+struct ModularArithmetic
+{
+    using Value = std::uint64_t;
+
+    std::uint64_t modulus{};
+
+    [[nodiscard]]
+    Value from(const std::uint64_t count) const noexcept
+    {
+        return count % this->modulus;
+    }
+
+    [[nodiscard]]
+    Value add(const Value a, const Value b) const noexcept
+    {
+        return static_cast<Value>((Count{a} + b) % this->modulus);
+    }
+
+    [[nodiscard]]
+    Value multiply(const Value a, const Value b) const noexcept
+    {
+        return static_cast<Value>(Count{a} * b % this->modulus);
+    }
+};
+
+/**
+ * @brief Unsigned integer of any size, as 64 bit limbs from least significant with no leading zero limbs
+ *
+ */
+struct BigCount
+{
+    std::vector<std::uint64_t> limbs;
+
+    [[nodiscard]]
+    bool operator==(const BigCount& rhs) const = default;
+
+    [[nodiscard]]
+    std::strong_ordering operator<=>(const BigCount& rhs) const noexcept
+    {
+        if (this->limbs.size() != rhs.limbs.size())
+            return this->limbs.size() <=> rhs.limbs.size();
+
+        return std::lexicographical_compare_three_way(this->limbs.rbegin(), this->limbs.rend(), rhs.limbs.rbegin(),
+            rhs.limbs.rend());
+    }
+};
+
+/**
+ * @brief Exact counts of any size. Slow, but they never overflow
+ *
+ */
+struct BigArithmetic
+{
+    using Value = BigCount;
+
+    [[nodiscard]]
+    Value from(const std::uint64_t count) const
+    {
+        return count == 0 ? Value{} : Value{{count}};
+    }
+
+    [[nodiscard]]
+    Value add(const Value& a, const Value& b) const
+    {
+        const Value& shorter{a.limbs.size() < b.limbs.size() ? a : b};
+        Value result{a.limbs.size() < b.limbs.size() ? b : a};
+
+        bool carry{false};
+        for (std::size_t i{}; i < result.limbs.size() && (i < shorter.limbs.size() || carry); ++i)
+        {
+            const std::uint64_t addend{i < shorter.limbs.size() ? shorter.limbs[i] : 0};
+
+            const bool first{__builtin_add_overflow(result.limbs[i], addend, &result.limbs[i])};
+            const bool second{__builtin_add_overflow(result.limbs[i], std::uint64_t{carry}, &result.limbs[i])};
+            carry = first || second;
+        }
+
+        if (carry)
+            result.limbs.push_back(1);
+
+        return result;
+    }
+
+    [[nodiscard]]
+    Value multiply(const Value& a, const Value& b) const
+    {
+        if (a.limbs.empty() || b.limbs.empty())
+            return {};
+
+        Value result;
+        result.limbs.resize(a.limbs.size() + b.limbs.size());
+
+        for (std::size_t i{}; i < a.limbs.size(); ++i)
+        {
+            // Never overflows, as (2^64 - 1)^2 + 2 * (2^64 - 1) is 2^128 - 1
+            Count carry{};
+            for (std::size_t j{}; j < b.limbs.size(); ++j)
+            {
+                const Count product{Count{a.limbs[i]} * b.limbs[j] + result.limbs[i + j] + carry};
+                result.limbs[i + j] = static_cast<std::uint64_t>(product);
+                carry = product >> 64;
+            }
+
+            result.limbs[i + b.limbs.size()] = static_cast<std::uint64_t>(carry);
+        }
+
+        if (result.limbs.back() == 0)
+            result.limbs.pop_back();
+
+        return result;
+    }
+};
+
+/**
+ * @brief Natural logarithms of counts. They never overflow, but rounding means counts that are close may compare
+ *        equal or out of order
+ *
+ */
+struct LogArithmetic
+{
+    using Value = double;
+
+    [[nodiscard]]
+    Value from(const std::uint64_t count) const noexcept
+    {
+        return count == 0 ? -std::numeric_limits<double>::infinity() : std::log(static_cast<double>(count));
+    }
+
+    [[nodiscard]]
+    Value add(Value a, Value b) const noexcept
+    {
+        if (a < b)
+            std::swap(a, b);
+        if (b == -std::numeric_limits<double>::infinity())
+            return a;
+
+        return a + std::log1p(std::exp(b - a));
+    }
+
+    [[nodiscard]]
+    Value multiply(const Value a, const Value b) const noexcept
+    {
+        return a + b;
+    }
+};
+
+/**
+ * @brief Insertion rules compiled into a transition over a state of counts: every letter, then the pairs of letters
+ *        that can ever occur, numbered densely with the pairs that have a rule first. A rule adds its pair's count to
+ *        the letter it inserts, so letter counts are kept up to date by every step instead of summed from the pairs.
+ *        A single step is a scatter-add over the pairs with rules, whose destinations are kept as structure of arrays.
+ *        Many steps at once are a power of the transition matrix by repeated squaring, which costs O(s^3 log n) for s
+ *        counts and n steps
+ *
+ */
+class PairSystem
 {
 public:
-    char last{};
+    /**
+     * @brief Compile rules for polymer, which must be at least one letter. Letters must be from 'A' to 'Z', or
+     *        std::runtime_error will be thrown
+     *
+     * @param polymer
+     * @param rules
+     */
+    PairSystem(const std::string_view polymer, const std::vector<InsertionRule>& rules)
+    {
+        // Letter inserted between each pair of letters, or NO_LETTER
+        std::array<std::size_t, LETTER_COUNT * LETTER_COUNT> insertions;
+        insertions.fill(NO_LETTER);
+
+        for (const InsertionRule& rule : rules)
+        {
+            insertions[letter(rule.left) * LETTER_COUNT + letter(rule.right)] = letter(rule.between);
+        }
+
+        // Number of each pair of letters in the order it was found, or NO_PAIR until it is found
+        std::array<std::size_t, LETTER_COUNT * LETTER_COUNT> numbers;
+        numbers.fill(NO_PAIR);
+
+        std::vector<std::size_t> pairLefts;
+        std::vector<std::size_t> pairRights;
+
+        const auto number{[&numbers, &pairLefts, &pairRights](const std::size_t left, const std::size_t right)
+            -> std::size_t
+        {
+            std::size_t& result{numbers[left * LETTER_COUNT + right]};
+            if (result == NO_PAIR)
+            {
+                result = pairLefts.size();
+                pairLefts.push_back(left);
+                pairRights.push_back(right);
+            }
+
+            return result;
+        }};
+
+        std::vector<std::size_t> polymerPairs;
+        for (std::size_t i{1}; i < polymer.size(); ++i)
+        {
+            polymerPairs.push_back(number(letter(polymer[i - 1]), letter(polymer[i])));
+        }
+
+        // Pairs found while following rules are numbered after every pair found so far, so this reaches all of them
+        for (std::size_t pair{}; pair < pairLefts.size(); ++pair)
+        {
+            const std::size_t between{insertions[pairLefts[pair] * LETTER_COUNT + pairRights[pair]]};
+            if (between != NO_LETTER)
+            {
+                number(pairLefts[pair], between);
+                number(between, pairRights[pair]);
+            }
+        }
+
+        // Position of each pair in the state, with the pairs that have a rule first
+        std::vector<std::size_t> positions(pairLefts.size());
+        std::size_t position{LETTER_COUNT};
+
+        for (const bool ruled : {true, false})
+        {
+            for (std::size_t pair{}; pair < pairLefts.size(); ++pair)
+            {
+                if ((insertions[pairLefts[pair] * LETTER_COUNT + pairRights[pair]] != NO_LETTER) == ruled)
+                    positions[pair] = position++;
+            }
+
+            if (ruled)
+            {
+                this->insertedLetters.resize(position - LETTER_COUNT);
+                this->leftDestinations.resize(position - LETTER_COUNT);
+                this->rightDestinations.resize(position - LETTER_COUNT);
+            }
+        }
+
+        for (std::size_t pair{}; pair < pairLefts.size(); ++pair)
+        {
+            const std::size_t left{pairLefts[pair]};
+            const std::size_t right{pairRights[pair]};
+            const std::size_t between{insertions[left * LETTER_COUNT + right]};
+
+            if (between == NO_LETTER)
+                continue;
+
+            const std::size_t ruled{positions[pair] - LETTER_COUNT};
+            this->insertedLetters[ruled] = between;
+            this->leftDestinations[ruled] = positions[numbers[left * LETTER_COUNT + between]];
+            this->rightDestinations[ruled] = positions[numbers[between * LETTER_COUNT + right]];
+        }
+
+        this->initial.resize(LETTER_COUNT + pairLefts.size());
+        for (const char c : polymer)
+        {
+            ++this->initial[letter(c)];
+        }
+        for (const std::size_t pair : polymerPairs)
+        {
+            ++this->initial[positions[pair]];
+        }
+    }
 
     /**
-     * @brief Return a reference to the number of times left has occured before right
-     * 
-     * @param left Left char of pair
-     * @param right Right char of pair
-     * @return Reference to the occurence count
+     * @brief How many times each letter occurs after steps, counted with arithmetic
+     *
+     * @param steps
+     * @param arithmetic
+     * @return std::array<typename Arithmetic::Value, LETTER_COUNT>
      */
+    template <typename Arithmetic>
+    [[nodiscard]]
+    std::array<typename Arithmetic::Value, LETTER_COUNT> letterCounts(const std::uint64_t steps,
+        const Arithmetic& arithmetic) const
+    {
+        const std::vector<typename Arithmetic::Value> state{this->advance(steps, arithmetic)};
+
+        // Letters are the start of the state
+        std::array<typename Arithmetic::Value, LETTER_COUNT> result;
+        std::copy_n(state.begin(), LETTER_COUNT, result.begin());
+
+        return result;
+    }
+private:
+    static constexpr std::size_t NO_LETTER{std::numeric_limits<std::size_t>::max()};
+    static constexpr std::size_t NO_PAIR{std::numeric_limits<std::size_t>::max()};
+
+    // Letter each pair with a rule inserts, and the positions in the state of the two pairs it turns into
+    std::vector<std::size_t> insertedLetters;
+    std::vector<std::size_t> leftDestinations;
+    std::vector<std::size_t> rightDestinations;
+
+    // Count of every letter, then of every pair, in the starting polymer
+    std::vector<std::uint64_t> initial;
+
     [[nodiscard]]
-    constexpr std::size_t& lookup(const char left, const char right)
+    static std::size_t letter(const char c)
     {
-        return this->matrix[static_cast<std::size_t>(left) - 'A'][static_cast<std::size_t>(right) - 'A'];
+        if (c < 'A' || c > 'Z')
+            throw std::runtime_error{"Elements must be letters from A to Z, not '" + std::string{c} + '\''};
+
+        return static_cast<std::size_t>(c - 'A');
     }
 
     /**
-     * @brief Preform one insertion step with the given rules
-     * 
-     * @param rules Rules for insertions
+     * @brief State after steps, one step at a time when that is cheaper than squaring the transition
+     *
+     * @param steps
+     * @param arithmetic
+     * @return std::vector<typename Arithmetic::Value>
      */
-    void insertionStep(const std::vector<InsertionRule>& rules)
+    template <typename Arithmetic>
+    [[nodiscard]]
+    std::vector<typename Arithmetic::Value> advance(std::uint64_t steps, const Arithmetic& arithmetic) const
     {
-        Polymer result{*this};
+        using Value = typename Arithmetic::Value;
+
+        const std::size_t size{this->initial.size()};
 
-        for (const auto& rule : rules)
+        std::vector<Value> state(size);
+        std::ranges::transform(this->initial, state.begin(), [&arithmetic](const std::uint64_t count) -> Value
         {
-            const std::size_t ammount{lookup(rule.left, rule.right)};
-            result.lookup(rule.left, rule.between) += ammount;
-            result.lookup(rule.between, rule.right) += ammount;
-            result.lookup(rule.left, rule.right) -= ammount;
+            return arithmetic.from(count);
+        });
+
+        // A step costs size, and squaring costs size^3 for every bit of steps
+        if (steps <= size * size * static_cast<std::uint64_t>(64 - std::countl_zero(steps)))
+        {
+            std::vector<Value> next(size);
+            for (; steps != 0; --steps)
+            {
+                this->step(state, next, arithmetic);
+                std::swap(state, next);
+            }
+
+            return state;
         }
 
-        *this = result;
+        // Column from, row to holds how many of to come from one of from. Letters and pairs without a rule stay
+        const Value one{arithmetic.from(1)};
+
+        std::vector<Value> transition(size * size, arithmetic.from(0));
+        for (std::size_t i{}; i < size; ++i)
+        {
+            if (i < LETTER_COUNT || i >= LETTER_COUNT + this->insertedLetters.size())
+                transition[i * size + i] = one;
+        }
+
+        for (std::size_t i{}; i < this->insertedLetters.size(); ++i)
+        {
+            const std::size_t from{LETTER_COUNT + i};
+            for (const std::size_t to : {this->insertedLetters[i], this->leftDestinations[i],
+                this->rightDestinations[i]})
+            {
+                transition[to * size + from] = arithmetic.add(transition[to * size + from], one);
+            }
+        }
+
+        for (; steps != 0; steps >>= 1)
+        {
+            if ((steps & 1) != 0)
+                state = multiply(transition, state, size, arithmetic);
+            if (steps > 1)
+                transition = multiply(transition, transition, size, arithmetic);
+        }
+
+        return state;
     }
 
     /**
-     * @brief Count how many times each character occurs
-     * 
-     * @return Array of counts where the index is a letter (1 through 25) and the value is the count of occurences
+     * @brief Write the state one step after state into next, which must be the same size
+     *
+     * @param state
+     * @param next
+     * @param arithmetic
      */
-    [[nodiscard]]
-    constexpr std::array<std::size_t, 26> counts() const
+    template <typename Arithmetic>
+    void step(const std::vector<typename Arithmetic::Value>& state, std::vector<typename Arithmetic::Value>& next,
+        const Arithmetic& arithmetic) const
     {
-        std::array<std::size_t, 26> result{};
+        const typename Arithmetic::Value zero{arithmetic.from(0)};
 
-        for (std::size_t i{}; i < result.size(); ++i)
+        // Letters and pairs without a rule carry over, and pairs with a rule are replaced
+        std::ranges::copy(state, next.begin());
+        for (std::size_t i{}; i < this->insertedLetters.size(); ++i)
         {
-            result[i] = std::accumulate(this->matrix[i].begin(), this->matrix[i].end(), static_cast<std::size_t>(0));
+            next[LETTER_COUNT + i] = zero;
         }
 
-        ++result[static_cast<std::size_t>(this->last) - 'A'];
+        for (std::size_t i{}; i < this->insertedLetters.size(); ++i)
+        {
+            const typename Arithmetic::Value count{state[LETTER_COUNT + i]};
 
-        return result;
+            next[this->insertedLetters[i]] = arithmetic.add(next[this->insertedLetters[i]], count);
+            next[this->leftDestinations[i]] = arithmetic.add(next[this->leftDestinations[i]], count);
+            next[this->rightDestinations[i]] = arithmetic.add(next[this->rightDestinations[i]], count);
+        }
     }
 
     /**
-     * @brief Return the number of characters
-     * 
-     * @return Number of characters
+     * @brief Product of the size * size matrix lhs and rhs, which is either a matrix of the same size or a column
+     *
+     * @param lhs
+     * @param rhs
+     * @param size
+     * @param arithmetic
+     * @return std::vector<typename Arithmetic::Value>
      */
+    template <typename Arithmetic>
     [[nodiscard]]
-    constexpr std::size_t size() const
+    static std::vector<typename Arithmetic::Value> multiply(const std::vector<typename Arithmetic::Value>& lhs,
+        const std::vector<typename Arithmetic::Value>& rhs, const std::size_t size, const Arithmetic& arithmetic)
     {
-        const std::array<std::size_t, 26> countValues{counts()};
-        return std::accumulate(countValues.begin(), countValues.end(), static_cast<std::size_t>(0));
+        using Value = typename Arithmetic::Value;
+
+        const Value zero{arithmetic.from(0)};
+        const std::size_t columns{rhs.size() / size};
+
+        std::vector<Value> result(size * columns, zero);
+        for (std::size_t row{}; row < size; ++row)
+        {
+            for (std::size_t k{}; k < size; ++k)
+            {
+                // Most of the transition is empty for the first few squarings
+                const Value factor{lhs[row * size + k]};
+                if (factor == zero)
+                    continue;
+
+                for (std::size_t column{}; column < columns; ++column)
+                {
+                    result[row * columns + column] = arithmetic.add(result[row * columns + column],
+                        arithmetic.multiply(factor, rhs[k * columns + column]));
+                }
+            }
+        }
+
+        return result;
     }
-private:
-    std::array<std::array<std::size_t, 26>, 26> matrix{};
 };
 
 /**
  * @brief Read starting polymer from first line of file
- * 
+ *
  * @param infile File to read from
  * @return Starting polymer value
  */
-static Polymer readStartingPolymer(std::ifstream& infile)
+static std::string readStartingPolymer(std::istream& infile)
 {
-    Polymer polymer;
-
     std::string line;
     std::getline(infile, line);
 
-    polymer.last = line.back();
-
-    for (std::size_t i{}; i < line.size() - 1; ++i)
-    {
-        ++polymer.lookup(line[i], line[i + 1]);
-    }
+    if (line.empty())
+        throw std::runtime_error{"Expected a starting polymer"};
 
-    return polymer;
+    return line;
 }
 
 /**
  * @brief Read rules from file
- * 
+ *
  * @param infile File to read from
  * @return Insertion rules
  */
-static std::vector<InsertionRule> readRules(std::ifstream& infile)
+static std::vector<InsertionRule> readRules(std::istream& infile)
 {
     std::vector<InsertionRule> rules;
 
@@ -144,44 +566,174 @@ static std::vector<InsertionRule> readRules(std::ifstream& infile)
     return rules;
 }
 
-int main()
+/**
+ * @brief Value of the environment variable name as a number, or fallback when it is not set
+ *
+ * @param name
+ * @param fallback
+ * @return std::uint64_t
+ */
+[[nodiscard]]
+static std::uint64_t environmentNumber(const char* const name, const std::uint64_t fallback)
 {
-    static constexpr int STEP_COUNT{40};
+    const char* const requested{std::getenv(name)};
+    return requested == nullptr ? fallback : aoc::parseInt<std::uint64_t>(requested);
+}
 
-    std::ifstream infile{"input.txt"};
+/**
+ * @brief std::to_string for Count
+ *
+ * @param value
+ * @return std::string
+ */
+[[nodiscard]]
+static std::string toString(Count value)
+{
+    std::string result;
+    do
+    {
+        result.push_back(static_cast<char>('0' + static_cast<int>(value % 10)));
+        value /= 10;
+    } while (value != 0);
+
+    std::ranges::reverse(result);
 
-    if (!infile.is_open())
+    return result;
+}
+
+/**
+ * @brief Most and least common letters of counts, skipping letters counted as none
+ *
+ * @param counts
+ * @param none
+ * @return std::pair<std::size_t, std::size_t> Most common letter first, as indices from 'A'
+ */
+template <typename Value>
+[[nodiscard]]
+static std::pair<std::size_t, std::size_t> extremesOf(const std::array<Value, LETTER_COUNT>& counts, const Value& none)
+{
+    std::size_t most{};
+    std::size_t least{};
+    for (std::size_t i{}; i < LETTER_COUNT; ++i)
     {
-        std::cerr << "ERROR! Could not open infile!\n";
-        return 1;
+        // Letters that never occur are not counted
+        if (counts[i] == none)
+            continue;
+
+        if (counts[most] == none || counts[i] > counts[most])
+            most = i;
+        if (counts[least] == none || counts[i] < counts[least])
+            least = i;
     }
 
-    Polymer polymer{readStartingPolymer(infile)};
+    return {most, least};
+}
 
-    // Ignore emtpy line
-    infile.ignore();
+/**
+ * @brief Whether logarithms a and b are too close to tell which of their counts is larger
+ *
+ * @param a
+ * @param b
+ * @return bool
+ */
+[[nodiscard]]
+static bool nearlyEqual(const double a, const double b) noexcept
+{
+    return std::abs(a - b) <= LOG_TIE_TOLERANCE * std::max({1.0, a, b});
+}
+
+/**
+ * @brief Most and least common letters after steps, whatever their counts are
+ *        Up to EXACT_STEP_LIMIT steps they are measured exactly, and beyond it by their logarithms, where
+ *        std::runtime_error will be thrown if another letter is too close to either of them to be told apart
+ *
+ * @param system
+ * @param steps
+ * @return std::pair<std::size_t, std::size_t> Most common letter first, as indices from 'A'
+ */
+[[nodiscard]]
+static std::pair<std::size_t, std::size_t> extremeLetters(const PairSystem& system, const std::uint64_t steps)
+{
+    if (steps <= EXACT_STEP_LIMIT)
+        return extremesOf(system.letterCounts(steps, BigArithmetic{}), BigCount{});
+
+    constexpr double NONE{-std::numeric_limits<double>::infinity()};
 
-    std::vector<InsertionRule> rules{readRules(infile)};
+    const std::array<double, LETTER_COUNT> logs{system.letterCounts(steps, LogArithmetic{})};
+    const auto[most, least]{extremesOf(logs, NONE)};
 
-    for (int i{}; i < STEP_COUNT; ++i)
+    for (std::size_t i{}; i < LETTER_COUNT; ++i)
     {
-        polymer.insertionStep(rules);
+        if (logs[i] == NONE)
+            continue;
+
+        if ((i != most && nearlyEqual(logs[i], logs[most])) || (i != least && nearlyEqual(logs[i], logs[least])))
+        {
+            throw std::runtime_error{"Letters after " + std::to_string(steps) +
+                " steps are too close in count to tell which is the most or least common"};
+        }
     }
 
-    std::array<std::size_t, 26> counts{polymer.counts()};
+    return {most, least};
+}
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    aoc::InputStream infile{input};
+
+    const std::string polymer{readStartingPolymer(infile)};
+
+    // Ignore emtpy line
+    infile.ignore();
+
+    const std::vector<InsertionRule> rules{readRules(infile)};
+
+    const std::uint64_t steps{environmentNumber("AOC_POLYMER_STEPS", STEP_COUNT)};
 
-    const std::size_t maxValue{*std::ranges::max_element(counts)};
+    // The answer is given modulo this when it is set
+    const std::uint64_t modulus{environmentNumber("AOC_POLYMER_MODULUS", 0)};
 
-    // Convert zeros into size_t max so zero isn't the min
-    for (std::size_t& count : counts)
+    aoc::beginPhase("solve");
+
+    const PairSystem system{polymer, rules};
+
+    if (modulus == 0)
     {
-        if (count == 0)
-            count = std::numeric_limits<std::size_t>::max();
+        try
+        {
+            std::array<Count, LETTER_COUNT> counts{system.letterCounts(steps, ExactArithmetic{})};
+
+            const Count maxValue{*std::ranges::max_element(counts)};
+
+            // Convert zeros into the largest count so zero isn't the min
+            for (Count& count : counts)
+            {
+                if (count == 0)
+                    count = std::numeric_limits<Count>::max();
+            }
+
+            const Count minValue{*std::ranges::min_element(counts)};
+
+            return toString(maxValue - minValue);
+        }
+        catch (const std::overflow_error&)
+        {
+            throw std::runtime_error{"Counts after " + std::to_string(steps) +
+                " steps do not fit in 128 bits, set AOC_POLYMER_MODULUS to get the answer modulo it"};
+        }
     }
 
-    const std::size_t minValue{*std::ranges::min_element(counts)};
+    const auto[most, least]{extremeLetters(system, steps)};
+
+    const ModularArithmetic arithmetic{modulus};
+    const std::array<std::uint64_t, LETTER_COUNT> counts{system.letterCounts(steps, arithmetic)};
 
-    std::cout << "Result: " << maxValue - minValue << '\n';
+    return std::to_string(arithmetic.add(counts[most], modulus - counts[least]));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -1,381 +1,303 @@
-#include <algorithm>
-#include <cmath>
+#include <array>
 #include <cstddef>
-#include <concepts>
-#include <fstream>
-#include <functional>
-#include <iostream>
+#include <cstdlib>
 #include <limits>
-#include <unordered_map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "grid.hpp"
+#include "heap.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
 /**
- * @brief Binary Heap
- * 
- * @tparam T Value Type
- * @tparam Comp Binary Predicate comparison function implementing less than
+ * @brief Risk of entering a tile from its digit
+ *
+ * @param c
+ * @return int
  */
-template <typename T, std::predicate<T, T> Comp = std::less<T>>
-class Heap
+[[nodiscard]]
+static int toCost(const char c) noexcept
 {
-public:
-    Heap(const Comp& a_comp) :
-        comp{a_comp}
-    {}
+    return c - '0';
+}
 
-    /**
-     * @brief Insert object of type U compatible with type T
-     * 
-     * @tparam U 
-     * @param value 
-     */
-    template <typename U>
-    void insert(U&& value)
-    {
-        this->array.push_back(std::forward<U>(value));
-        this->indices.insert({this->array.back(), this->array.size() - 1});
-        heapifyUp();
-    }
+/**
+ * @brief The actual map is tile "cloned" scaleFactor times in each direction
+ *        The costs in each copy are 1 more than the corresponding tile in the copy directly above or to the left
+ *        Every cost is worked out once here, so searches only look costs up. The result is padded by 1
+ *
+ * @param tile
+ * @param scaleFactor
+ * @return aoc::Grid<int>
+ */
+[[nodiscard]]
+static aoc::Grid<int> expandMap(const aoc::Grid<int>& tile, const std::size_t scaleFactor = 5)
+{
+    aoc::Grid<int> map(tile.width() * scaleFactor, tile.height() * scaleFactor, 0, 1);
 
-    /**
-     * @brief Return top (min) element from heap
-     * 
-     * @return Top (min) element from heap
-     */
-    [[nodiscard]]
-    T& top()
+    for (std::size_t y{}; y < map.height(); ++y)
     {
-        return this->array.front();
-    }
+        for (std::size_t x{}; x < map.width(); ++x)
+        {
+            const std::size_t distance{x / tile.width() + y / tile.height()};
 
-    /**
-     * @brief Return top (min) element from heap
-     * 
-     * @return Top (min) element from heap
-     */
-    [[nodiscard]]
-    const T& top() const
-    {
-        return this->array.front();
+            // Costs wrap from 9 back to 1
+            map(x, y) = (tile(x % tile.width(), y % tile.height()) - 1 + static_cast<int>(distance % 9)) % 9 + 1;
+        }
     }
 
-    /**
-     * @brief Remove top element from heap
-     * 
-     */
-    void pop()
-    {
-        this->indices.erase(this->array.front());
-        std::swap(this->array.front(), this->array.back());
-        this->array.pop_back();
+    return map;
+}
 
-        heapifyDown();
-    }
-
-    /**
-     * @brief Reevaluate the placement of the given value
-     * 
-     * @param value 
-     */
-    void decrease(const T& value)
-    {
-        heapifyUp(this->indices.at(value));
-    }
-private:
-    /**
-     * @brief Calculate left child index of node
-     * 
-     * @param node Parent index
-     * @return Left child index of node
-     */
-    [[nodiscard]]
-    static constexpr std::size_t leftIndex(const std::size_t node) noexcept
-    {
-        return (node * 2) + 1;
-    }
+// Highest cost of any tile
+static constexpr int MAX_COST{9};
 
+/**
+ * @brief Priority queue for priorities that are pushed no lower than the last one popped and less than Span past it
+ *        Buckets are reused in a ring indexed by priority % Span, so push and pop are O(1) and nothing is compared
+ *        Entries are never updated in place, so callers must skip the stale ones left behind by a better push
+ *
+ * @tparam Span
+ */
+template <std::size_t Span>
+class BucketQueue
+{
+public:
     /**
-     * @brief Calculate right child index of node
-     * 
-     * @param node Parent index
-     * @return Right child index of node
+     * @brief Before the first pop, priorities must be in [start, start + Span)
+     *
+     * @param start
      */
-    [[nodiscard]]
-    static constexpr std::size_t rightIndex(const std::size_t node) noexcept
-    {
-        return (node * 2) + 2;
-    }
+    explicit BucketQueue(const int start) :
+        current{start}
+    {}
 
-    /**
-     * @brief Calculate parent index of node
-     * 
-     * @param node Child index
-     * @return Parent index of node
-     */
     [[nodiscard]]
-    static constexpr std::size_t parentIndex(const std::size_t node) noexcept
+    bool empty() const noexcept
     {
-        return (node - 1) / 2;
+        return this->count == 0;
     }
 
-    /**
-     * @brief Correct a heap upwards from the bottom
-     * 
-     */
-    void heapifyUp()
+    void push(const std::size_t id, const int priority)
     {
-        heapifyUp(this->array.size() - 1);
+        this->buckets[static_cast<std::size_t>(priority) % Span].push_back(id);
+        ++this->count;
     }
 
     /**
-     * @brief Correct a heap upwards from the given index
-     * 
-     * @param node Index to work updwards from
+     * @brief Remove an id with the lowest priority. The queue must not be empty
+     *
+     * @return std::pair<std::size_t, int> Id and its priority
      */
-    void heapifyUp(const std::size_t node)
+    [[nodiscard]]
+    std::pair<std::size_t, int> pop()
     {
-        if (node == 0)
-            return;
-
-        const std::size_t parentPos{parentIndex(node)};
-
-        T& self{this->array[node]};
-        T& parent{this->array[parentPos]};
-
-        if (this->comp(self, parent))
+        while (this->buckets[static_cast<std::size_t>(this->current) % Span].empty())
         {
-            this->indices.at(self) = parentPos;
-            this->indices.at(parent) = node;
-            std::swap(self, parent);
-
-            heapifyUp(parentPos);
+            ++this->current;
         }
-    }
-
-    /**
-     * @brief Correct heap downwards from given index
-     * 
-     * @param node Index to start from
-     */
-    void heapifyDown(const std::size_t node = 0)
-    {
-        const std::size_t leftPos{leftIndex(node)};
-
-        if (leftPos >= this->array.size())
-            return;
 
-        T* const self{this->array.data() + node};
-        T* const left{this->array.data() + leftPos};
-        T* minChild = left;
+        std::vector<std::size_t>& bucket{this->buckets[static_cast<std::size_t>(this->current) % Span]};
+        const std::size_t id{bucket.back()};
+        bucket.pop_back();
+        --this->count;
 
-        const std::size_t rightPos{rightIndex(node)};
-        T* const right{this->array.data() + rightPos};
-
-        if (rightPos < this->array.size())
-            minChild = const_cast<T*>(&std::min(*left, *right, this->comp));
-
-        if (this->comp(*minChild, *self))
-        {
-            const std::size_t minChildPos{static_cast<std::size_t>(std::distance(this->array.data(), minChild))};
-
-            this->indices.at(*self) = minChildPos;
-            this->indices.at(*minChild) = node;
-            std::swap(*self, *minChild);
-
-            heapifyDown(minChildPos);
-        }
+        return {id, this->current};
     }
-
-    std::vector<T> array;
-    std::unordered_map<T, std::size_t> indices;
-    Comp comp{};
+private:
+    std::array<std::vector<std::size_t>, Span> buckets;
+    int current;
+    std::size_t count{};
 };
 
-class Map
+/**
+ * @brief Run Dijkstra's shortest path to find shortest path from upper right corner to upper left corner
+ * 
+ * @param map Padded by at least 1
+ * @return Shortest path from upper right corner to upper left corner
+ */
+[[nodiscard]]
+static int dijkstras(const aoc::Grid<int>& map)
 {
-public:
-    Map(std::vector<std::vector<int>>&& a_array, const std::size_t a_scaleFactor = 5) :
-        array{std::move(a_array)}, scaleFactor{a_scaleFactor}
-    {}
+    // Distance to every point. The border is 0, which no path can improve on, so it is never explored
+    aoc::Grid<int> distances(map.width(), map.height(), std::numeric_limits<int>::max(), map.padding(), 0);
 
-    [[nodiscard]]
-    constexpr std::size_t width() const noexcept
-    {
-        return this->array.front().size() * this->scaleFactor;
-    }
+    const std::size_t start{distances.index(0, 0)};
+    const std::size_t destination{distances.index(map.width() - 1, map.height() - 1)};
+    distances[start] = 0;
 
-    [[nodiscard]]
-    constexpr std::size_t height() const noexcept
-    {
-        return this->array.size() * this->scaleFactor;
-    }
+    // Priority queue for node with shortest distance. Points are only queued once a path to them is found
+    aoc::IndexedHeap<int> queue{distances.cellCount()};
+    queue.push(static_cast<aoc::IndexedHeap<int>::Id>(start), 0);
 
-    // The actual map is "clone" scaleFactor times in each direction.
-    // The costs in each copy are 1 more than the corresponding tile in the copy directly above or to the left
-    // These clones are implemented virtually by calcualting true cost of each tile on lookup
-    [[nodiscard]]
-    int cost(const std::size_t x, const std::size_t y) const
+    // Run until the dest node is the closest
+    while (queue.top() != destination)
     {
-        const std::size_t actualX{x % this->array.front().size()};
-        const std::size_t actualY{y % this->array.size()};
+        const std::size_t point{queue.top()};
+        const int pointDistance{queue.topPriority()};
 
-        const std::size_t distanceX{(x - actualX) / this->array.front().size()};
-        const std::size_t distanceY{(y - actualY) / this->array.size()};
-
-        std::size_t distance{distanceX + distanceY};
+        // Move on to the next node. Distances never shrink below one already popped, so it won't be queued again
+        queue.pop();
 
-        int value{this->array[actualY][actualX]};
-        for (; distance != 0; --distance)
+        // Check if any neighbors should be updated to travel via the current node
+        for (const std::size_t neighbor : distances.orthogonal(point))
         {
-            ++value;
-            if (value == 10)
-                value = 1;
+            int& neighborDistance{distances[neighbor]};
+
+            const int candidateDistance{pointDistance + map[neighbor]};
+
+            // If the neighbor is unvisted or the current node is better as a via node, update the path
+            if (candidateDistance < neighborDistance)
+            {
+                neighborDistance = candidateDistance;
+                queue.pushOrDecrease(static_cast<aoc::IndexedHeap<int>::Id>(neighbor), candidateDistance);
+            }
         }
-        
-        return value;
     }
-private:
-    std::vector<std::vector<int>> array;
-    std::size_t scaleFactor{5};
-};
+
+    return distances[destination];
+}
 
 /**
- * @brief Read map from file
+ * @brief Dijkstra's shortest path with a bucket queue (Dial's algorithm). Every step costs 1 to MAX_COST, so a queued
+ *        distance is never more than MAX_COST past the one being expanded and MAX_COST + 1 buckets are enough
  * 
- * @param infile File to read from
- * @return Map as 2D vector
+ * @param map Padded by at least 1
+ * @return Shortest path from upper right corner to upper left corner
  */
 [[nodiscard]]
-static Map readMap(std::ifstream& infile)
+static int dials(const aoc::Grid<int>& map)
 {
-    std::vector<std::vector<int>> map(1);
+    // Distance to every point. The border is 0, which no path can improve on, so it is never explored
+    aoc::Grid<int> distances(map.width(), map.height(), std::numeric_limits<int>::max(), map.padding(), 0);
 
-    char value;
-    while (infile.get(value))
-    {
-        if (value == '\n')
-            map.emplace_back();
-        else
-            map.back().push_back(value - '0');
-    }
+    const std::size_t start{distances.index(0, 0)};
+    const std::size_t destination{distances.index(map.width() - 1, map.height() - 1)};
+    distances[start] = 0;
 
-    map.pop_back();
+    BucketQueue<MAX_COST + 1> queue{0};
+    queue.push(start, 0);
 
-    return map;
-}
-
-struct Point
-{
-    std::size_t x{};
-    std::size_t y{};
+    while (!queue.empty())
+    {
+        const auto[point, pointDistance]{queue.pop()};
 
-    constexpr bool operator==(const Point& rhs) const = default;
-};
+        // Skip entries left behind when a shorter path was found later
+        if (pointDistance != distances[point])
+            continue;
 
-template <>
-struct std::hash<Point>
-{
-    std::size_t operator()(const Point& point) const noexcept
-    {
-        const std::hash<std::size_t> func;
-        const std::size_t xHash{func(point.x)};
-        const std::size_t yHash{func(point.y)};
+        if (point == destination)
+            return pointDistance;
 
-        return xHash ^ (yHash << 1);
+        for (const std::size_t neighbor : distances.orthogonal(point))
+        {
+            const int candidateDistance{pointDistance + map[neighbor]};
+            if (candidateDistance < distances[neighbor])
+            {
+                distances[neighbor] = candidateDistance;
+                queue.push(neighbor, candidateDistance);
+            }
+        }
     }
-};
+
+    throw std::runtime_error{"No path to the bottom right corner"};
+}
 
 /**
- * @brief Run Dijkstra's shortest path to find shortest path from upper right corner to upper left corner
+ * @brief A* search ordered by distance so far plus the Manhattan distance left, using a bucket queue
+ *        Every step costs at least 1, so the estimate never overshoots and drops by at most the cost of a step.
+ *        The estimate of a neighbor is then 0 to MAX_COST + 1 past the current one, which MAX_COST + 2 buckets cover
  * 
- * @param map
+ * @param map Padded by at least 1
  * @return Shortest path from upper right corner to upper left corner
  */
-static int dijkstras(const Map& map)
+[[nodiscard]]
+static int aStar(const aoc::Grid<int>& map)
 {
-    std::vector<std::vector<int>> distances(map.height());
-    std::ranges::fill(distances, std::vector<int>(map.width(), std::numeric_limits<int>::max()));
-    distances[0][0] = 0;
+    // Distance to every point. The border is 0, which no path can improve on, so it is never explored
+    aoc::Grid<int> distances(map.width(), map.height(), std::numeric_limits<int>::max(), map.padding(), 0);
 
-    // Compare two points based on their distance from the above array
-    const auto compPoints{[&distances](const Point& lhs, const Point& rhs) -> bool
+    const auto remaining{[&distances](const std::size_t point) -> int
     {
-        return distances[lhs.y][lhs.x] < distances[rhs.y][rhs.x];
+        const auto[x, y]{distances.coordinates(point)};
+        return static_cast<int>((distances.width() - 1 - x) + (distances.height() - 1 - y));
     }};
 
-    // Priority queue for node with shortest distance
-    Heap<Point, decltype(compPoints)> queue{compPoints};
+    const std::size_t start{distances.index(0, 0)};
+    const std::size_t destination{distances.index(map.width() - 1, map.height() - 1)};
+    distances[start] = 0;
 
-    for (std::size_t y{}; y < map.height(); ++y)
-    {
-        for (std::size_t x{}; x < map.width(); ++x)
-        {
-            queue.insert(Point{x, y});
-        }
-    }
+    BucketQueue<MAX_COST + 2> queue{remaining(start)};
+    queue.push(start, remaining(start));
 
-    // Run until the dest node is the closest
-    while (queue.top() != Point{map.width() - 1, map.height() - 1})
+    while (!queue.empty())
     {
-        const Point& point{queue.top()};
-        const int pointDistance{distances[point.y][point.x]};
-
-        // Check what directions have neighbors
-        const bool goNorth{point.y > 0};
-        const bool goSouth{point.y < map.height() - 1};
-        const bool goEast{point.x < map.width() - 1};
-        const bool goWest{point.x > 0};
-
-        // Array of neighbors that exist
-        std::array<Point, 4> explore;
-        std::size_t exploreCount{};
-
-        if (goNorth)
-            explore[exploreCount++] = {point.x, point.y - 1};
-        if (goSouth)
-            explore[exploreCount++] = {point.x, point.y + 1};
-        if (goEast)
-            explore[exploreCount++] = {point.x + 1, point.y};
-        if (goWest)
-            explore[exploreCount++] = {point.x - 1, point.y};
+        const auto[point, estimate]{queue.pop()};
+        const int pointDistance{estimate - remaining(point)};
 
-        // Check if any neighbors should be updated to travel via the current node
-        for (std::size_t i{}; i < exploreCount; ++i)
-        {
-            const Point& neighbor{explore[i]};
-            int& neighborDistance{distances[neighbor.y][neighbor.x]};
+        // Skip entries left behind when a shorter path was found later
+        if (pointDistance != distances[point])
+            continue;
 
-            const int candidateDistance{pointDistance + map.cost(neighbor.x, neighbor.y)};
+        if (point == destination)
+            return pointDistance;
 
-            // If the neighbor is unvisted or the current node is better as a via node, update the path
-            if (neighborDistance == std::numeric_limits<int>::max() || candidateDistance < neighborDistance)
+        for (const std::size_t neighbor : distances.orthogonal(point))
+        {
+            const int candidateDistance{pointDistance + map[neighbor]};
+            if (candidateDistance < distances[neighbor])
             {
-                neighborDistance = candidateDistance;
-                queue.decrease(neighbor);
+                distances[neighbor] = candidateDistance;
+                queue.push(neighbor, candidateDistance + remaining(neighbor));
             }
         }
-
-        // Move on to the next node
-        queue.pop();
     }
 
-    return distances.back().back();
+    throw std::runtime_error{"No path to the bottom right corner"};
 }
 
-int main()
+/**
+ * @brief Shortest path using the search named by the AOC_CHITON_SEARCH environment variable:
+ *        "dijkstra" for the indexed heap, "dial" for the bucket queue or "astar" for A* on the bucket queue
+ *        Dial's algorithm is used when it is not set. std::runtime_error will be thrown for any other name
+ * 
+ * @param map 
+ * @return int 
+ */
+[[nodiscard]]
+static int shortestPath(const aoc::Grid<int>& map)
 {
-    std::ifstream infile{"input.txt"};
+    const char* const requested{std::getenv("AOC_CHITON_SEARCH")};
+    const std::string_view search{requested == nullptr ? "dial" : requested};
 
-    if (!infile.is_open())
-    {
-        std::cerr << "ERROR! Could not open infile!\n";
-        return 1;
-    }
+    if (search == "dijkstra")
+        return dijkstras(map);
+    if (search == "dial")
+        return dials(map);
+    if (search == "astar")
+        return aStar(map);
 
-    const Map map{readMap(infile)};
+    throw std::runtime_error{"Unknown search \"" + std::string{search} + "\", expected dijkstra, dial or astar"};
+}
+
+[[nodiscard]]
+static std::string solve(const std::string_view input)
+{
+    aoc::beginPhase("parse");
+
+    const aoc::Grid<int> map{expandMap(aoc::parseGrid<int>(input, toCost))};
 
-    std::cout << "Result: " << dijkstras(map) << '\n';
+    aoc::beginPhase("solve");
+
+    return std::to_string(shortestPath(map));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
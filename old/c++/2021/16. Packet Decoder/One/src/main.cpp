@@ -1,37 +1,38 @@
 #include <cassert>
 #include <cstddef>
-#include <fstream>
-#include <iostream>
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "simd.hpp"
+#include "solution.hpp"
+
+namespace
+{
+
 static constexpr std::size_t BITS_PER_HEX_DIGIT{4};
-static constexpr std::size_t BITS_PER_BYTE{8};
+static constexpr std::size_t BITS_PER_WORD{64};
+static constexpr std::size_t HEX_DIGITS_PER_WORD{BITS_PER_WORD / BITS_PER_HEX_DIGIT};
 static constexpr std::size_t BITS_PER_CHILD_COUNT{11};
 static constexpr std::size_t BITS_PER_CHILD_LENGTH{15};
 
 /**
- * @brief Read input hex data from file
+ * @brief Read input hex data from the contents of the input file
  * 
- * @return Contents of first (only) line as a string
+ * @param input Contents of the input file
+ * @return Contents of first (only) line
  */
 [[nodiscard]]
-static std::string readInput()
+static std::string_view readInput(const std::string_view input)
 {
-    std::ifstream infile{"input.txt"};
-    if (!infile.is_open())
-        throw std::runtime_error{"Cannot open input file"};
-
-    std::string input;
-    std::getline(infile, input);
-
-    return input;
+    return input.substr(0, input.find('\n'));
 }
 
 /**
- * @brief Convert hex digit to decimal
+ * @brief Convert hex digit to decimal. Only '0' to '9' and 'A' to 'F' are hex digits, std::runtime_error will be thrown
+ *        for anything else
  * 
  * @param digit Hex digit to convert
  * @return Hex digit in decimal form
@@ -39,126 +40,236 @@ static std::string readInput()
 [[nodiscard]]
 static unsigned char hexDigitToU8(const char digit)
 {
-    return static_cast<unsigned char>(digit <= '9' ? digit - '0' : digit - 'A' + static_cast<char>(10));
+    if (digit >= '0' && digit <= '9')
+        return static_cast<unsigned char>(digit - '0');
+    if (digit >= 'A' && digit <= 'F')
+        return static_cast<unsigned char>(digit - 'A' + 10);
+
+    throw std::runtime_error{"Invalid hex digit '" + std::string{digit} + '\''};
 }
 
-/**
- * @brief Convert hex string into binary 
- * 
- * @param hex Hex string to convert
- * @return Binary represention of string
- */
-[[nodiscard]]
-static std::vector<bool> hexToBinary(const std::string& hex)
-{
-    std::vector<bool> result;
-    result.reserve(hex.size() * BITS_PER_HEX_DIGIT);
+#ifdef AOC_SIMD_X86
+// Both kernels decode whole words of hex from digit on into words, and return where the first partial word starts. A
+// block with anything but hex digits in it is left for the scalar decoder to report
 
-    for (const char digit : hex)
+[[gnu::target("sse2")]]
+static std::size_t decodeSse2(const std::string_view hex, std::size_t digit, std::uint64_t* const words) noexcept
+{
+    const __m128i zero{_mm_set1_epi8('0')};
+    const __m128i letterA{_mm_set1_epi8('A')};
+    const __m128i nine{_mm_set1_epi8(9)};
+    const __m128i five{_mm_set1_epi8(5)};
+    const __m128i ten{_mm_set1_epi8(10)};
+    const __m128i lowBytes{_mm_set1_epi16(0x00FF)};
+
+    for (; hex.size() - digit >= HEX_DIGITS_PER_WORD; digit += HEX_DIGITS_PER_WORD)
     {
-        const unsigned char byte{hexDigitToU8(digit)};
+        const __m128i text{_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex.data() + digit))};
 
-        for (int bit{BITS_PER_HEX_DIGIT - 1}; bit > -1; --bit)
-        {
-            result.push_back((byte & (1 << bit)) >> bit);
-        }
+        // Subtracting the first digit or letter only leaves a value below ten or six for characters in that range
+        const __m128i digits{_mm_sub_epi8(text, zero)};
+        const __m128i letters{_mm_sub_epi8(text, letterA)};
+        const __m128i isDigit{_mm_cmpeq_epi8(_mm_min_epu8(digits, nine), digits)};
+        const __m128i isLetter{_mm_cmpeq_epi8(_mm_min_epu8(letters, five), letters)};
+
+        if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF)
+            break;
+
+        const __m128i nibbles{_mm_or_si128(_mm_and_si128(isDigit, digits),
+            _mm_andnot_si128(isDigit, _mm_add_epi8(letters, ten)))};
+
+        // Every 16 bit lane holds two nibbles, the first in its low byte, and gets the byte they make in its low byte
+        const __m128i bytes{_mm_and_si128(_mm_or_si128(_mm_slli_epi16(nibbles, 4), _mm_srli_epi16(nibbles, 8)),
+            lowBytes)};
+
+        // Bytes are in transmission order, so the first one must become the most significant
+        std::uint64_t word;
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&word), _mm_packus_epi16(bytes, bytes));
+        words[digit / HEX_DIGITS_PER_WORD] = __builtin_bswap64(word);
     }
 
-    return result;
+    return digit;
 }
 
-struct Packet
+[[gnu::target("avx2")]]
+static std::size_t decodeAvx2(const std::string_view hex, std::uint64_t* const words) noexcept
 {
-    unsigned char version{};
-
-    enum class Type
+    const __m256i zero{_mm256_set1_epi8('0')};
+    const __m256i letterA{_mm256_set1_epi8('A')};
+    const __m256i nine{_mm256_set1_epi8(9)};
+    const __m256i five{_mm256_set1_epi8(5)};
+    const __m256i ten{_mm256_set1_epi8(10)};
+    const __m256i lowBytes{_mm256_set1_epi16(0x00FF)};
+
+    std::size_t digit{};
+    for (; hex.size() - digit >= 2 * HEX_DIGITS_PER_WORD; digit += 2 * HEX_DIGITS_PER_WORD)
     {
-        LITERAL = 4
-    };
-    Type type{};
+        const __m256i text{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex.data() + digit))};
 
-    // Only one will be used per packet
-    unsigned long long int value;
-    std::vector<Packet> children;
-};
+        const __m256i digits{_mm256_sub_epi8(text, zero)};
+        const __m256i letters{_mm256_sub_epi8(text, letterA)};
+        const __m256i isDigit{_mm256_cmpeq_epi8(_mm256_min_epu8(digits, nine), digits)};
+        const __m256i isLetter{_mm256_cmpeq_epi8(_mm256_min_epu8(letters, five), letters)};
 
-/**
- * @brief Convert "bits" (at most 8) bits of binary data starting at "it" into decimal
- * 
- * @param it Starting iterator
- * @param bits Number of bits to convert. At most 8
- * @return Decimal representation of binary data
- */
-static unsigned char bitsToU8(std::vector<bool>::const_iterator it, const int bits)
-{
-    assert(static_cast<std::size_t>(bits) <= sizeof(unsigned short int) * BITS_PER_BYTE);
+        if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) != -1)
+            break;
 
-    unsigned char value{};
+        const __m256i nibbles{_mm256_or_si256(_mm256_and_si256(isDigit, digits),
+            _mm256_andnot_si256(isDigit, _mm256_add_epi8(letters, ten)))};
+        const __m256i bytes{_mm256_and_si256(
+            _mm256_or_si256(_mm256_slli_epi16(nibbles, 4), _mm256_srli_epi16(nibbles, 8)), lowBytes)};
 
-    for (int i{bits - 1}; i > -1; --i, ++it)
-    {
-        value |= static_cast<unsigned char>((*it ? 1 : 0) << i);
+        // Packing works within each 128 bit half, so each half holds one word in its low 8 bytes
+        const __m256i packed{_mm256_packus_epi16(bytes, bytes)};
+
+        std::uint64_t first;
+        std::uint64_t second;
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&first), _mm256_castsi256_si128(packed));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&second), _mm256_extracti128_si256(packed, 1));
+
+        words[digit / HEX_DIGITS_PER_WORD] = __builtin_bswap64(first);
+        words[digit / HEX_DIGITS_PER_WORD + 1] = __builtin_bswap64(second);
     }
 
-    return value;
+    return decodeSse2(hex, digit, words);
 }
+#endif
 
 /**
- * @brief Convert "bits" (at most 16) bits of binary data starting at "it" into decimal
+ * @brief Bits of a hex transmission, packed first bit most significant into 64 bit words
+ *        Reads are a shift of a cached window holding the next 64 bits, which is refilled from at most two words
  * 
- * @param it Starting iterator
- * @param bits Number of bits to convert. At most 16
- * @return Decimal representation of binary data
  */
-static unsigned short int bitsToU16(std::vector<bool>::const_iterator it, const int bits)
+class BitReader
 {
-    assert(static_cast<std::size_t>(bits) <= sizeof(unsigned short int) * BITS_PER_BYTE);
+public:
+    /**
+     * @brief Decode hex, which must be only hex digits or std::runtime_error will be thrown
+     * 
+     * @param hex 
+     */
+    explicit BitReader(const std::string_view hex) :
+        words(hex.size() / HEX_DIGITS_PER_WORD + 2), bitCount{hex.size() * BITS_PER_HEX_DIGIT}
+    {
+        std::size_t digit{};
+
+#ifdef AOC_SIMD_X86
+        switch (aoc::simd::level())
+        {
+        case aoc::simd::Level::AVX2:
+            digit = decodeAvx2(hex, this->words.data());
+            break;
+        case aoc::simd::Level::SSE2:
+            digit = decodeSse2(hex, 0, this->words.data());
+            break;
+        case aoc::simd::Level::Scalar:
+            break;
+        }
+#endif
+
+        for (; digit < hex.size(); ++digit)
+        {
+            const std::size_t shift{(HEX_DIGITS_PER_WORD - 1 - digit % HEX_DIGITS_PER_WORD) * BITS_PER_HEX_DIGIT};
+            this->words[digit / HEX_DIGITS_PER_WORD] |= std::uint64_t{hexDigitToU8(hex[digit])} << shift;
+        }
 
-    unsigned short int value{};
+        this->refill();
+    }
 
-    for (int i{bits - 1}; i > -1; --i, ++it)
+    /**
+     * @brief Bits read so far
+     * 
+     * @return std::size_t 
+     */
+    [[nodiscard]]
+    std::size_t position() const noexcept
     {
-        value |= static_cast<unsigned char>((*it ? 1 : 0) << i);
+        return this->position_;
     }
 
-    return value;
-}
+    /**
+     * @brief Read the next count bits, at least 1 and at most 64, as a number. std::runtime_error will be thrown if
+     *        there are not that many bits left
+     * 
+     * @param count 
+     * @return std::uint64_t 
+     */
+    std::uint64_t read(const std::size_t count)
+    {
+        assert(count >= 1 && count <= BITS_PER_WORD);
+
+        if (count > this->bitCount - this->position_)
+            throw std::runtime_error{"Packet runs past the end of the transmission"};
 
-static Packet parsePacket(const std::vector<bool>& input, std::size_t& i);
+        const std::uint64_t value{this->window >> (BITS_PER_WORD - count)};
+
+        this->position_ += count;
+        this->refill();
+
+        return value;
+    }
+private:
+    // Followed by a zero word, so the window can always be filled from two
+    std::vector<std::uint64_t> words;
+    std::size_t bitCount{};
+
+    std::size_t position_{};
+
+    // Next 64 bits from position_, the first one most significant
+    std::uint64_t window{};
+
+    void refill() noexcept
+    {
+        const std::size_t word{this->position_ / BITS_PER_WORD};
+        const std::size_t offset{this->position_ % BITS_PER_WORD};
+
+        // The second word is shifted in two steps, since shifting by all 64 bits is undefined
+        this->window = this->words[word] << offset | this->words[word + 1] >> 1 >> (BITS_PER_WORD - 1 - offset);
+    }
+};
+
+struct Packet
+{
+    unsigned char version{};
+
+    enum class Type
+    {
+        LITERAL = 4
+    };
+    Type type{};
+
+    // Only one will be used per packet
+    unsigned long long int value;
+    std::vector<Packet> children;
+};
+
+static Packet parsePacket(BitReader& reader);
 
 /**
  * @brief Parse literal for packet value from input
  * 
- * @param input Binary packet data
- * @param i Index to start parsing
+ * @param reader Binary packet data, positioned at the literal
  * @return Decimal representation of literal value fo packet
  */
-static unsigned long long int parseLiteralValue(const std::vector<bool>& input, std::size_t& i)
+static unsigned long long int parseLiteralValue(BitReader& reader)
 {
-    std::vector<unsigned char> segments;
+    unsigned long long int value{};
+    std::size_t segments{};
 
     // Run loop until a 4-bit chunk is prefixed by a zero
-
-    bool last{!input[i]};
+    bool last{};
     do
     {
-        last = !input[i];
-        ++i;
-
-        // Read one segment (hex digit) worth of binary
-        segments.push_back(bitsToU8(input.begin() + static_cast<std::ptrdiff_t>(i), 4));
-        i += BITS_PER_HEX_DIGIT;
-    } while (!last);
+        // Read one segment (hex digit) worth of binary along with its prefix
+        const std::uint64_t segment{reader.read(BITS_PER_HEX_DIGIT + 1)};
+        last = (segment >> BITS_PER_HEX_DIGIT) == 0;
 
-    if (segments.size() > sizeof(unsigned long long int) * 2)
-        throw std::runtime_error{std::string{1, '"'} + std::to_string(segments.size()) + "\" is too many segemtns for literal"};
+        if (++segments > sizeof(unsigned long long int) * 2)
+            throw std::runtime_error{'"' + std::to_string(segments) + "\" is too many segments for literal"};
 
-    // Concatinate segments
-    unsigned long long int value{};
-    for (std::size_t j{}; j < segments.size(); ++j)
-    {
-        value |= static_cast<unsigned long long int>(segments[j]) << ((segments.size() - j- 1) * BITS_PER_HEX_DIGIT);
-    }
+        // Concatinate segments
+        value = value << BITS_PER_HEX_DIGIT | (segment & ((1U << BITS_PER_HEX_DIGIT) - 1));
+    } while (!last);
 
     return value;
 }
@@ -166,22 +277,20 @@ static unsigned long long int parseLiteralValue(const std::vector<bool>& input,
 /**
  * @brief Parse children of a packet that uses a child count
  * 
- * @param input Binary packet data
- * @param i Index to start parsing
+ * @param reader Binary packet data, positioned at the children
  * @return Array of all child packets
  */
-static std::vector<Packet> parseChildrenByCount(const std::vector<bool>& input, std::size_t& i)
+static std::vector<Packet> parseChildrenByCount(BitReader& reader)
 {
     std::vector<Packet> children;
 
-    const std::size_t count{bitsToU16(input.begin() + static_cast<std::ptrdiff_t>(i), BITS_PER_CHILD_COUNT)};
-    i += BITS_PER_CHILD_COUNT;
+    const std::size_t count{reader.read(BITS_PER_CHILD_COUNT)};
 
     children.reserve(count);
 
     for (std::size_t j{}; j < count; ++j)
     {
-        children.push_back(parsePacket(input, i));
+        children.push_back(parsePacket(reader));
     }
 
     return children;
@@ -190,22 +299,20 @@ static std::vector<Packet> parseChildrenByCount(const std::vector<bool>& input,
 /**
  * @brief Parse children of a packet that uses a child length
  * 
- * @param input Binary packet data
- * @param i Index to start parsing
+ * @param reader Binary packet data, positioned at the children
  * @return Array of all child packets
  */
-static std::vector<Packet> parseChildrenByLength(const std::vector<bool>& input, std::size_t& i)
+static std::vector<Packet> parseChildrenByLength(BitReader& reader)
 {
     std::vector<Packet> children;
 
-    const std::size_t length{bitsToU16(input.begin() + static_cast<std::ptrdiff_t>(i), BITS_PER_CHILD_LENGTH)};
-    i += BITS_PER_CHILD_LENGTH;
+    const std::size_t length{reader.read(BITS_PER_CHILD_LENGTH)};
 
-    const std::size_t end{i + length};
+    const std::size_t end{reader.position() + length};
 
-    while (i < end)
+    while (reader.position() < end)
     {
-        children.push_back(parsePacket(input, i));
+        children.push_back(parsePacket(reader));
     }
 
     return children;
@@ -214,44 +321,40 @@ static std::vector<Packet> parseChildrenByLength(const std::vector<bool>& input,
 /**
  * @brief Parse all children of an operator packet
  * 
- * @param input Binary packet data
- * @param i Index to start parsing
+ * @param reader Binary packet data, positioned at the children
  * @return Array of all child packets
  */
-static std::vector<Packet> parseChildren(const std::vector<bool>& input, std::size_t& i)
+static std::vector<Packet> parseChildren(BitReader& reader)
 {
-    const bool countMode{input[i++]};
+    const bool countMode{reader.read(1) != 0};
 
     if (countMode)
-        return parseChildrenByCount(input, i);
+        return parseChildrenByCount(reader);
     else
-        return parseChildrenByLength(input, i);
+        return parseChildrenByLength(reader);
 }
 
 /**
  * @brief Parse a packet and all of it's children, recusively
  * 
- * @param input Binary packet data
- * @param i Index to start parsing
+ * @param reader Binary packet data, positioned at the packet
  * @return Packet 
  */
-static Packet parsePacket(const std::vector<bool>& input, std::size_t& i)
+static Packet parsePacket(BitReader& reader)
 {
     Packet packet;
 
-    packet.version = bitsToU8(input.begin() + static_cast<std::ptrdiff_t>(i), 3);
-    i += 3;
+    packet.version = static_cast<unsigned char>(reader.read(3));
 
-    packet.type = static_cast<Packet::Type>(bitsToU8(input.begin() + static_cast<std::ptrdiff_t>(i), 3));
-    i += 3;
+    packet.type = static_cast<Packet::Type>(reader.read(3));
 
     switch (packet.type)
     {
         case Packet::Type::LITERAL:
-            packet.value = parseLiteralValue(input, i);
+            packet.value = parseLiteralValue(reader);
             break;
         default:
-            packet.children = parseChildren(input, i);
+            packet.children = parseChildren(reader);
             break;
     }
 
@@ -270,24 +373,19 @@ static int sumVersions(const Packet& packet)
     return sum;
 }
 
-/**
- * @brief 
- * 
- * @param input Binary packet data
- * @return Packet 
- */
-static Packet parsePacket(const std::vector<bool>& input)
+[[nodiscard]]
+static std::string solve(const std::string_view input)
 {
-    std::size_t i{};
-    return parsePacket(input, i);
-}
+    aoc::beginPhase("parse");
 
-int main()
-{
-    const std::vector<bool> input{hexToBinary(readInput())};
-    const Packet root{parsePacket(input)};
+    BitReader reader{readInput(input)};
+    const Packet root{parsePacket(reader)};
+
+    aoc::beginPhase("solve");
 
-    std::cout << sumVersions(root) << '\n';
+    return std::to_string(sumVersions(root));
+}
+
+}
 
-    return 0;
-}
\ No newline at end of file
+AOC_SOLUTION(solve)
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef AOC_RUNNER_BENCHMARK_H
+#define AOC_RUNNER_BENCHMARK_H
+
+#include <ostream>
+#include <vector>
+
+#include "solution.hpp"
+
+namespace aoc
+{
+
+struct BenchmarkOptions
+{
+    // Untimed runs before measuring so caches, branch predictors and the allocator settle
+    int warmup{3};
+    int iterations{20};
+
+    // Also count CPU cycles and cache misses with perf_event_open, summed over the calling thread and every worker of
+    // aoc::threadPool(). Skipped with a warning when the kernel refuses
+    bool counters{false};
+};
+
+struct BenchmarkInput
+{
+    const Solution* solution{};
+    InputFile input;
+};
+
+/**
+ * @brief Time every solution on its input and write min, median and p99 of each phase and of the total as JSON
+ *        A solution that throws is reported with its error instead of timings
+ *
+ * @param inputs
+ * @param options
+ * @param out
+ * @return true if every solution ran, else false
+ */
+bool runBenchmarks(const std::vector<BenchmarkInput>& inputs, const BenchmarkOptions& options, std::ostream& out);
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,464 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "benchmark.hpp"
+#include "threads.hpp"
+
+namespace aoc
+{
+
+namespace
+{
+
+struct CounterValues
+{
+    std::uint64_t cycles{};
+    std::uint64_t cacheMisses{};
+};
+
+/**
+ * @brief CPU cycle and cache miss counters for every thread of the process, including the workers of
+ *        aoc::threadPool(). Each thread is counted by its own perf event group, and reads add the groups together
+ *        Threads started after the counters are opened are not counted
+ *
+ */
+class PerfCounters
+{
+public:
+    PerfCounters()
+    {
+#ifdef __linux__
+        // Started now, so its workers are among the threads counted
+        static_cast<void>(threadPool());
+
+        std::error_code error;
+        for (const std::filesystem::directory_entry& entry :
+            std::filesystem::directory_iterator{"/proc/self/task", error})
+        {
+            const std::string name{entry.path().filename().string()};
+
+            int thread{};
+            const auto[last, parseError]{std::from_chars(name.data(), name.data() + name.size(), thread)};
+            if (parseError != std::errc{} || last != name.data() + name.size() || !this->openGroup(thread))
+            {
+                this->closeGroups();
+                return;
+            }
+        }
+
+        if (error)
+        {
+            this->closeGroups();
+            return;
+        }
+
+        for (const Group& group : this->groups)
+        {
+            ioctl(group.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+        this->closeGroups();
+    }
+
+    [[nodiscard]]
+    bool valid() const
+    {
+        return !this->groups.empty();
+    }
+
+    /**
+     * @brief Totals since the counters were opened. Only differences between two reads mean anything
+     *
+     * @return CounterValues
+     */
+    [[nodiscard]]
+    CounterValues read() const
+    {
+        CounterValues result;
+
+#ifdef __linux__
+        for (const Group& group : this->groups)
+        {
+            // Layout of PERF_FORMAT_GROUP without any other read_format flags
+            struct
+            {
+                std::uint64_t count;
+                std::uint64_t values[2];
+            } values{};
+
+            if (::read(group.leader, &values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)))
+            {
+                result.cycles += values.values[0];
+                result.cacheMisses += values.values[1];
+            }
+        }
+#endif
+
+        return result;
+    }
+private:
+    // Counters of one thread, read together through the leader
+    struct Group
+    {
+        int leader{-1};
+        int member{-1};
+    };
+
+    std::vector<Group> groups;
+
+    void closeGroups() noexcept
+    {
+#ifdef __linux__
+        for (const Group& group : this->groups)
+        {
+            close(group.member);
+            close(group.leader);
+        }
+#endif
+
+        this->groups.clear();
+    }
+
+#ifdef __linux__
+    /**
+     * @brief Open a group counting thread and add it to groups
+     *
+     * @param thread
+     * @return true if the kernel allowed it, else false
+     */
+    [[nodiscard]]
+    bool openGroup(const int thread)
+    {
+        const int leader{open(thread, PERF_COUNT_HW_CPU_CYCLES, -1)};
+        if (leader == -1)
+            return false;
+
+        const int member{open(thread, PERF_COUNT_HW_CACHE_MISSES, leader)};
+        if (member == -1)
+        {
+            close(leader);
+            return false;
+        }
+
+        this->groups.push_back({leader, member});
+        return true;
+    }
+
+    [[nodiscard]]
+    static int open(const int thread, const std::uint64_t config, const int groupLeader)
+    {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = groupLeader == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, thread, -1, groupLeader, 0));
+    }
+#endif
+};
+
+struct PhaseSample
+{
+    std::string_view phase;
+    std::int64_t nanoseconds{};
+    CounterValues counters;
+};
+
+/**
+ * @brief Splits one run of a solution into the phases it marks with aoc::beginPhase()
+ *
+ */
+class PhaseTimer final : public PhaseRecorder
+{
+public:
+    explicit PhaseTimer(const PerfCounters& a_counters) : counters{a_counters} {}
+
+    void start()
+    {
+        this->samples.clear();
+        this->named = false;
+        this->phase = "solve";
+        this->counterStart = this->readCounters();
+        this->timeStart = std::chrono::steady_clock::now();
+    }
+
+    void begin(const std::string_view a_phase) override
+    {
+        // Work before the first mark belongs to the first marked phase
+        if (!this->named)
+        {
+            this->named = true;
+            this->phase = a_phase;
+            return;
+        }
+
+        this->record();
+        this->phase = a_phase;
+        this->counterStart = this->readCounters();
+        this->timeStart = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief End the current phase. Phases entered more than once are added together
+     *
+     * @return const std::vector<PhaseSample>& Phases in the order they were first entered
+     */
+    const std::vector<PhaseSample>& finish()
+    {
+        this->record();
+        return this->samples;
+    }
+private:
+    const PerfCounters& counters;
+
+    std::vector<PhaseSample> samples;
+    bool named{false};
+
+    std::string_view phase;
+    std::chrono::steady_clock::time_point timeStart;
+    CounterValues counterStart;
+
+    [[nodiscard]]
+    CounterValues readCounters() const
+    {
+        return this->counters.valid() ? this->counters.read() : CounterValues{};
+    }
+
+    void record()
+    {
+        const std::chrono::steady_clock::time_point timeEnd{std::chrono::steady_clock::now()};
+        const CounterValues counterEnd{this->readCounters()};
+
+        auto sample{std::ranges::find(this->samples, this->phase, &PhaseSample::phase)};
+        if (sample == this->samples.end())
+            sample = this->samples.insert(sample, {this->phase, 0, {}});
+
+        sample->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(timeEnd - this->timeStart).count();
+        sample->counters.cycles += counterEnd.cycles - this->counterStart.cycles;
+        sample->counters.cacheMisses += counterEnd.cacheMisses - this->counterStart.cacheMisses;
+    }
+};
+
+// Installs a recorder for aoc::beginPhase() and always removes it again, even if the solution throws
+class RecorderScope
+{
+public:
+    explicit RecorderScope(PhaseRecorder& recorder)
+    {
+        phaseRecorder() = &recorder;
+    }
+
+    RecorderScope(const RecorderScope&) = delete;
+    RecorderScope& operator=(const RecorderScope&) = delete;
+
+    ~RecorderScope()
+    {
+        phaseRecorder() = nullptr;
+    }
+};
+
+// Every iteration's measurements for one phase
+struct PhaseSeries
+{
+    std::string_view phase;
+    std::vector<std::int64_t> nanoseconds;
+    std::vector<std::int64_t> cycles;
+    std::vector<std::int64_t> cacheMisses;
+
+    void add(const PhaseSample& sample)
+    {
+        this->nanoseconds.push_back(sample.nanoseconds);
+        this->cycles.push_back(static_cast<std::int64_t>(sample.counters.cycles));
+        this->cacheMisses.push_back(static_cast<std::int64_t>(sample.counters.cacheMisses));
+    }
+};
+
+[[nodiscard]]
+static std::string escapeJson(const std::string_view str)
+{
+    static constexpr std::string_view hexDigits{"0123456789abcdef"};
+
+    std::string escaped;
+    escaped.reserve(str.size());
+
+    for (const char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                escaped += "\\u00";
+                escaped += hexDigits[static_cast<unsigned char>(c) >> 4];
+                escaped += hexDigits[static_cast<unsigned char>(c) & 0xF];
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+    }
+
+    return escaped;
+}
+
+/**
+ * @brief Write "key": {"min": ..., "median": ..., "p99": ...}. p99 is the nearest rank, so it is the max below 100 samples
+ *
+ * @param out
+ * @param key
+ * @param values Must not be empty
+ */
+static void writeStats(std::ostream& out, const std::string_view key, std::vector<std::int64_t> values)
+{
+    std::ranges::sort(values);
+
+    const std::size_t size{values.size()};
+    const std::int64_t median{size % 2 == 1 ? values[size / 2] : (values[size / 2 - 1] + values[size / 2]) / 2};
+    const std::int64_t p99{values[(size * 99 + 99) / 100 - 1]};
+
+    out << '"' << key << "\": {\"min\": " << values.front() << ", \"median\": " << median << ", \"p99\": " << p99 << '}';
+}
+
+static void writeSeries(std::ostream& out, const PhaseSeries& series, const bool counters)
+{
+    writeStats(out, "nanoseconds", series.nanoseconds);
+
+    if (counters)
+    {
+        out << ", ";
+        writeStats(out, "cycles", series.cycles);
+        out << ", ";
+        writeStats(out, "cacheMisses", series.cacheMisses);
+    }
+}
+
+}
+
+bool runBenchmarks(const std::vector<BenchmarkInput>& inputs, const BenchmarkOptions& options, std::ostream& out)
+{
+    const PerfCounters perfCounters;
+    const bool counters{options.counters && perfCounters.valid()};
+    if (options.counters && !counters)
+        std::cerr << "WARNING! perf_event_open is not available, hardware counters will not be reported\n";
+
+    PhaseTimer timer{perfCounters};
+    bool success{true};
+
+    out << "{\n";
+    out << "  \"warmup\": " << options.warmup << ",\n";
+    out << "  \"iterations\": " << options.iterations << ",\n";
+    out << "  \"counters\": " << (counters ? "true" : "false") << ",\n";
+    out << "  \"solutions\": [";
+
+    for (std::size_t i{0}; i < inputs.size(); ++i)
+    {
+        const Solution& solution{*inputs[i].solution};
+        const std::string_view input{inputs[i].input.view()};
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"year\": " << solution.year << ", \"day\": " << solution.day << ", \"part\": " << solution.part <<
+            ", \"name\": \"" << escapeJson(solution.name) << "\", ";
+
+        std::string answer;
+        PhaseSeries total{"total", {}, {}, {}};
+        std::vector<PhaseSeries> phases;
+
+        try
+        {
+            for (int j{0}; j < options.warmup; ++j)
+                static_cast<void>(solution.solve(input));
+
+            const RecorderScope scope{timer};
+
+            for (int j{0}; j < options.iterations; ++j)
+            {
+                timer.start();
+                answer = solution.solve(input);
+
+                PhaseSample sum{"total", 0, {}};
+                for (const PhaseSample& sample : timer.finish())
+                {
+                    auto series{std::ranges::find(phases, sample.phase, &PhaseSeries::phase)};
+                    if (series == phases.end())
+                        series = phases.insert(series, {sample.phase, {}, {}, {}});
+                    series->add(sample);
+
+                    sum.nanoseconds += sample.nanoseconds;
+                    sum.counters.cycles += sample.counters.cycles;
+                    sum.counters.cacheMisses += sample.counters.cacheMisses;
+                }
+                total.add(sum);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            out << "\"error\": \"" << escapeJson(e.what()) << "\"}";
+            success = false;
+            continue;
+        }
+
+        out << "\"answer\": \"" << escapeJson(answer) << "\",\n";
+        out << "     \"total\": {";
+        writeSeries(out, total, counters);
+        out << "},\n";
+        out << "     \"phases\": [";
+
+        for (std::size_t j{0}; j < phases.size(); ++j)
+        {
+            out << (j == 0 ? "" : ", ") << "{\"name\": \"" << escapeJson(phases[j].phase) << "\", ";
+            writeSeries(out, phases[j], counters);
+            out << '}';
+        }
+
+        out << "]}";
+    }
+
+    out << "\n  ]\n}\n";
+
+    return success;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "solution.hpp"
+
+/**
+ * @brief Which solutions to run and where to find their input. Zero for year, day or part matches everything
+ *
+ */
+struct Options
+{
+    int year{};
+    int day{};
+    int part{};
+
+    std::string root{AOC_SOURCE_DIR};
+    std::string inputFile;
+
+    // Threads for parallel solutions to use. Zero leaves AOC_THREADS as it is
+    int threads{};
+
+    // Time the solutions instead of printing their answers. JSON is written to jsonFile, or stdout if it is empty
+    bool bench{false};
+    aoc::BenchmarkOptions benchmark;
+    std::string jsonFile;
+};
+
+static void printUsage(const char* const program)
+{
+    std::cerr << "Usage: " << program << " [--year YEAR] [--day DAY] [--part PART] [--input FILE] [--root DIR] [--threads N] [--list]\n" <<
+        "       " << program << " --bench [--warmup N] [--iterations N] [--counters] [--json FILE] [filters...]\n";
+}
+
+/**
+ * @brief Parse a whole string as a non-negative integer
+ *
+ * @param str
+ * @param value
+ * @return true if all of str was a number, else false
+ */
+[[nodiscard]]
+static bool parseInt(const std::string_view str, int& value)
+{
+    const auto[last, error]{std::from_chars(str.data(), str.data() + str.size(), value)};
+    return error == std::errc{} && last == str.data() + str.size() && value >= 0;
+}
+
+/**
+ * @brief Check if a solution is selected by the year, day and part filters
+ *
+ * @param options
+ * @param solution
+ * @return true if solution should be run, else false
+ */
+[[nodiscard]]
+static bool selected(const Options& options, const aoc::Solution& solution)
+{
+    return (options.year == 0 || options.year == solution.year) &&
+        (options.day == 0 || options.day == solution.day) &&
+        (options.part == 0 || options.part == solution.part);
+}
+
+[[nodiscard]]
+static std::string inputPath(const Options& options, const aoc::Solution& solution)
+{
+    return options.inputFile.empty() ? options.root + '/' + std::string{solution.inputFile} : options.inputFile;
+}
+
+/**
+ * @brief Load every input up front so file reads stay out of the timings, then benchmark the solutions
+ *
+ * @param options
+ * @param solutions
+ * @return int Exit status
+ */
+[[nodiscard]]
+static int runBenchmarks(const Options& options, const std::vector<aoc::Solution>& solutions)
+{
+    std::vector<aoc::BenchmarkInput> inputs;
+    inputs.reserve(solutions.size());
+
+    try
+    {
+        for (const aoc::Solution& solution : solutions)
+            inputs.push_back({&solution, aoc::InputFile{inputPath(options, solution)}});
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "ERROR! " << e.what() << '\n';
+        return 1;
+    }
+
+    if (options.jsonFile.empty())
+        return aoc::runBenchmarks(inputs, options.benchmark, std::cout) ? 0 : 1;
+
+    std::ofstream outfile{options.jsonFile};
+    if (!outfile.is_open())
+    {
+        std::cerr << "ERROR! Failed to open \"" << options.jsonFile << "\"\n";
+        return 1;
+    }
+
+    return aoc::runBenchmarks(inputs, options.benchmark, outfile) ? 0 : 1;
+}
+
+int main(const int argc, const char** const argv)
+{
+    Options options;
+    bool list{false};
+
+    for (int i{1}; i < argc; ++i)
+    {
+        const std::string_view arg{argv[i]};
+
+        if (arg == "--list")
+        {
+            list = true;
+            continue;
+        }
+
+        if (arg == "--bench")
+        {
+            options.bench = true;
+            continue;
+        }
+
+        if (arg == "--counters")
+        {
+            options.benchmark.counters = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const std::string_view value{argv[++i]};
+
+        bool valid{true};
+        if (arg == "--year")
+            valid = parseInt(value, options.year);
+        else if (arg == "--day")
+            valid = parseInt(value, options.day);
+        else if (arg == "--part")
+            valid = parseInt(value, options.part);
+        else if (arg == "--input")
+            options.inputFile = value;
+        else if (arg == "--root")
+            options.root = value;
+        else if (arg == "--threads")
+            valid = parseInt(value, options.threads) && options.threads > 0;
+        else if (arg == "--warmup")
+            valid = parseInt(value, options.benchmark.warmup);
+        else if (arg == "--iterations")
+            valid = parseInt(value, options.benchmark.iterations) && options.benchmark.iterations > 0;
+        else if (arg == "--json")
+            options.jsonFile = value;
+        else
+            valid = false;
+
+        if (!valid)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Run in calendar order regardless of link order
+    std::vector<aoc::Solution> solutions{aoc::solutions()};
+    std::ranges::sort(solutions, [](const aoc::Solution& lhs, const aoc::Solution& rhs) -> bool
+    {
+        if (lhs.year != rhs.year)
+            return lhs.year < rhs.year;
+        if (lhs.day != rhs.day)
+            return lhs.day < rhs.day;
+        return lhs.part < rhs.part;
+    });
+
+    std::erase_if(solutions, [&options](const aoc::Solution& solution) -> bool
+    {
+        return !selected(options, solution);
+    });
+
+    if (solutions.empty())
+    {
+        std::cerr << "ERROR! No solutions match the given year, day and part\n";
+        return 1;
+    }
+
+    if (!options.inputFile.empty() && solutions.size() != 1)
+    {
+        std::cerr << "ERROR! --input can only be used when exactly one solution is selected\n";
+        return 1;
+    }
+
+    // Solutions read the thread count from the environment, the same way they do when run on their own
+    if (options.threads > 0)
+        ::setenv("AOC_THREADS", std::to_string(options.threads).c_str(), 1);
+
+    if (options.bench && !list)
+        return runBenchmarks(options, solutions);
+
+    int status{0};
+
+    for (const aoc::Solution& solution : solutions)
+    {
+        std::cout << solution.year << " day " << solution.day << " part " << solution.part << " (" << solution.name << "): ";
+
+        if (list)
+        {
+            std::cout << solution.inputFile << '\n';
+            continue;
+        }
+
+        try
+        {
+            const aoc::InputFile input{inputPath(options, solution)};
+            const std::string answer{solution.solve(input.view())};
+
+            // Multi-line answers start on their own line
+            if (answer.find('\n') != std::string::npos)
+                std::cout << '\n';
+
+            std::cout << answer << '\n';
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "ERROR! " << e.what() << '\n';
+            status = 1;
+        }
+    }
+
+    return status;
+}
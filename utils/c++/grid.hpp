@@ -0,0 +1,532 @@
+#ifndef AOC_CPP_GRID_H
+#define AOC_CPP_GRID_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "input.hpp"
+
+namespace aoc
+{
+
+namespace detail
+{
+
+/**
+ * @brief Size of a grid and the mapping from coordinates to cells in its flat buffer
+ *        Rows are stored one after another, with padding extra cells on every side of the width * height interior
+ *
+ */
+class GridShape
+{
+public:
+    GridShape() = default;
+
+    GridShape(const std::size_t a_width, const std::size_t a_height, const std::size_t a_padding) noexcept :
+        m_width{a_width}, m_height{a_height}, m_padding{a_padding}
+    {}
+
+    [[nodiscard]]
+    std::size_t width() const noexcept
+    {
+        return this->m_width;
+    }
+
+    [[nodiscard]]
+    std::size_t height() const noexcept
+    {
+        return this->m_height;
+    }
+
+    [[nodiscard]]
+    std::size_t padding() const noexcept
+    {
+        return this->m_padding;
+    }
+
+    /**
+     * @brief Distance between vertically neighboring cells in the buffer
+     *
+     * @return std::size_t
+     */
+    [[nodiscard]]
+    std::size_t stride() const noexcept
+    {
+        return this->m_width + 2 * this->m_padding;
+    }
+
+    /**
+     * @brief Number of cells in the buffer, border included
+     *
+     * @return std::size_t
+     */
+    [[nodiscard]]
+    std::size_t cellCount() const noexcept
+    {
+        return this->stride() * (this->m_height + 2 * this->m_padding);
+    }
+
+    /**
+     * @brief Whether (x, y) is in the interior
+     *
+     * @param x
+     * @param y
+     * @return true if x < width and y < height
+     */
+    [[nodiscard]]
+    bool contains(const std::size_t x, const std::size_t y) const noexcept
+    {
+        return x < this->m_width && y < this->m_height;
+    }
+
+    /**
+     * @brief Position of (x, y) in the buffer. Coordinates wrap like any other std::size_t, so x - 1 at x = 0 lands
+     *        in the border on the left. Anything down to -padding or up to width/height + padding - 1 is a valid cell
+     *
+     * @param x
+     * @param y
+     * @return std::size_t
+     */
+    [[nodiscard]]
+    std::size_t index(const std::size_t x, const std::size_t y) const noexcept
+    {
+        return (y + this->m_padding) * this->stride() + (x + this->m_padding);
+    }
+
+    /**
+     * @brief Inverse of index(x, y). Border cells give wrapped coordinates
+     *
+     * @param position
+     * @return std::pair<std::size_t, std::size_t> x and y
+     */
+    [[nodiscard]]
+    std::pair<std::size_t, std::size_t> coordinates(const std::size_t position) const noexcept
+    {
+        return {position % this->stride() - this->m_padding, position / this->stride() - this->m_padding};
+    }
+
+    /**
+     * @brief Cells to the north, south, east and west of position, in that order. Wraps around the edges unless
+     *        there is padding, so any interior cell of a padded grid has all 4
+     *
+     * @param position
+     * @return std::array<std::size_t, 4>
+     */
+    [[nodiscard]]
+    std::array<std::size_t, 4> orthogonal(const std::size_t position) const noexcept
+    {
+        const std::size_t rowStep{this->stride()};
+        return {position - rowStep, position + rowStep, position + 1, position - 1};
+    }
+
+    /**
+     * @brief The orthogonal neighbors of position, then the north-east, south-east, south-west and north-west ones
+     *
+     * @param position
+     * @return std::array<std::size_t, 8>
+     */
+    [[nodiscard]]
+    std::array<std::size_t, 8> adjacent(const std::size_t position) const noexcept
+    {
+        const std::size_t rowStep{this->stride()};
+        return {position - rowStep, position + rowStep, position + 1, position - 1, position - rowStep + 1,
+            position + rowStep + 1, position + rowStep - 1, position - rowStep - 1};
+    }
+private:
+    std::size_t m_width{};
+    std::size_t m_height{};
+    std::size_t m_padding{};
+};
+
+}
+
+/**
+ * @brief Every step'th element starting at first, such as a column of a Grid
+ *
+ * @tparam T
+ */
+template <typename T>
+class StridedView : public std::ranges::view_interface<StridedView<T>>
+{
+public:
+    class iterator
+    {
+    public:
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(T* const a_current, const std::size_t a_step) noexcept :
+            current{a_current}, step{a_step}
+        {}
+
+        [[nodiscard]]
+        T& operator*() const noexcept
+        {
+            return *this->current;
+        }
+
+        iterator& operator++() noexcept
+        {
+            this->current += this->step;
+            return *this;
+        }
+
+        [[nodiscard]]
+        iterator operator++(const int) noexcept
+        {
+            iterator copy{*this};
+            this->current += this->step;
+            return copy;
+        }
+
+        [[nodiscard]]
+        bool operator==(const iterator& rhs) const noexcept
+        {
+            return this->current == rhs.current;
+        }
+    private:
+        T* current{nullptr};
+        std::size_t step{};
+    };
+
+    StridedView() = default;
+
+    StridedView(T* const a_first, const std::size_t a_count, const std::size_t a_step) noexcept :
+        first{a_first}, count{a_count}, step{a_step}
+    {}
+
+    [[nodiscard]]
+    iterator begin() const noexcept
+    {
+        return {this->first, this->step};
+    }
+
+    // One step past the last element, which must still be inside the buffer or one past its end
+    [[nodiscard]]
+    iterator end() const noexcept
+    {
+        return {this->first + this->count * this->step, this->step};
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept
+    {
+        return this->count;
+    }
+
+    [[nodiscard]]
+    T& operator[](const std::size_t i) const noexcept
+    {
+        return this->first[i * this->step];
+    }
+private:
+    T* first{nullptr};
+    std::size_t count{};
+    std::size_t step{};
+};
+
+/**
+ * @brief 2D grid in a single contiguous buffer, stored row by row
+ *        An optional border of padding cells on every side lets neighbor lookups run off the edge without bounds
+ *        checks, as long as the border holds a value that stops whatever is looking, such as a wall or a height
+ *        nothing can climb
+ *
+ * @tparam T
+ */
+template <typename T>
+class Grid : public detail::GridShape
+{
+public:
+    Grid() = default;
+
+    /**
+     * @brief Grid of width * height cells surrounded by padding cells of border on every side
+     *
+     * @param a_width
+     * @param a_height
+     * @param value Value of every interior cell
+     * @param a_padding Cells of border on each side
+     * @param border Value of every border cell
+     */
+    Grid(const std::size_t a_width, const std::size_t a_height, const T& value = {}, const std::size_t a_padding = 0,
+        const T& border = {}) :
+        detail::GridShape{a_width, a_height, a_padding}, cells(this->cellCount(), border)
+    {
+        for (std::size_t y{}; y < this->height(); ++y)
+        {
+            std::ranges::fill(this->row(y), value);
+        }
+    }
+
+    [[nodiscard]]
+    T& operator()(const std::size_t x, const std::size_t y) noexcept
+    {
+        return this->cells[this->index(x, y)];
+    }
+
+    [[nodiscard]]
+    const T& operator()(const std::size_t x, const std::size_t y) const noexcept
+    {
+        return this->cells[this->index(x, y)];
+    }
+
+    /**
+     * @brief Cell by its position in the buffer, see index(x, y)
+     *
+     * @param position
+     * @return T&
+     */
+    [[nodiscard]]
+    T& operator[](const std::size_t position) noexcept
+    {
+        return this->cells[position];
+    }
+
+    [[nodiscard]]
+    const T& operator[](const std::size_t position) const noexcept
+    {
+        return this->cells[position];
+    }
+
+    /**
+     * @brief Interior cell at (x, y). std::out_of_range will be thrown if it is outside the interior
+     *
+     * @param x
+     * @param y
+     * @return T&
+     */
+    [[nodiscard]]
+    T& at(const std::size_t x, const std::size_t y)
+    {
+        if (!this->contains(x, y))
+            throw std::out_of_range{"Grid cell is out of range"};
+
+        return (*this)(x, y);
+    }
+
+    [[nodiscard]]
+    const T& at(const std::size_t x, const std::size_t y) const
+    {
+        if (!this->contains(x, y))
+            throw std::out_of_range{"Grid cell is out of range"};
+
+        return (*this)(x, y);
+    }
+
+    /**
+     * @brief Interior cells of row y
+     *
+     * @param y
+     * @return std::span<T>
+     */
+    [[nodiscard]]
+    std::span<T> row(const std::size_t y) noexcept
+    {
+        return {this->cells.data() + this->index(0, y), this->width()};
+    }
+
+    [[nodiscard]]
+    std::span<const T> row(const std::size_t y) const noexcept
+    {
+        return {this->cells.data() + this->index(0, y), this->width()};
+    }
+
+    /**
+     * @brief Interior cells of column x
+     *
+     * @param x
+     * @return StridedView<T>
+     */
+    [[nodiscard]]
+    StridedView<T> column(const std::size_t x) noexcept
+    {
+        return {this->cells.data() + this->index(x, 0), this->height(), this->stride()};
+    }
+
+    [[nodiscard]]
+    StridedView<const T> column(const std::size_t x) const noexcept
+    {
+        return {this->cells.data() + this->index(x, 0), this->height(), this->stride()};
+    }
+
+    /**
+     * @brief Every cell in the buffer, border included, in the order of index(x, y)
+     *
+     * @return std::span<T>
+     */
+    [[nodiscard]]
+    std::span<T> cellsWithBorder() noexcept
+    {
+        return this->cells;
+    }
+
+    [[nodiscard]]
+    std::span<const T> cellsWithBorder() const noexcept
+    {
+        return this->cells;
+    }
+
+    /**
+     * @brief Set every border cell to value, leaving the interior alone
+     *
+     * @param value
+     */
+    void fillBorder(const T& value)
+    {
+        const std::size_t rowStep{this->stride()};
+        const std::size_t interiorStart{this->padding() * rowStep};
+        const std::size_t interiorEnd{this->cells.size() - interiorStart};
+
+        std::fill(this->cells.begin(), this->cells.begin() + static_cast<std::ptrdiff_t>(interiorStart), value);
+        std::fill(this->cells.begin() + static_cast<std::ptrdiff_t>(interiorEnd), this->cells.end(), value);
+
+        for (std::size_t start{interiorStart}; start < interiorEnd; start += rowStep)
+        {
+            for (std::size_t i{}; i < this->padding(); ++i)
+            {
+                this->cells[start + i] = value;
+                this->cells[start + rowStep - 1 - i] = value;
+            }
+        }
+    }
+private:
+    std::vector<T> cells;
+};
+
+/**
+ * @brief Grid of flags packed 64 to a word, for visited sets and other masks that would waste 7 bits in every byte
+ *        Cells are read by value and written with set, since a single bit can not be referenced
+ *
+ */
+template <>
+class Grid<bool> : public detail::GridShape
+{
+public:
+    Grid() = default;
+
+    Grid(const std::size_t a_width, const std::size_t a_height, const bool value = false,
+        const std::size_t a_padding = 0, const bool border = false) :
+        detail::GridShape{a_width, a_height, a_padding}, words((this->cellCount() + 63) / 64, border ? ~Word{0} : 0)
+    {
+        if (value == border)
+            return;
+
+        for (std::size_t y{}; y < this->height(); ++y)
+        {
+            for (std::size_t x{}; x < this->width(); ++x)
+            {
+                this->set(this->index(x, y), value);
+            }
+        }
+    }
+
+    [[nodiscard]]
+    bool operator()(const std::size_t x, const std::size_t y) const noexcept
+    {
+        return (*this)[this->index(x, y)];
+    }
+
+    [[nodiscard]]
+    bool operator[](const std::size_t position) const noexcept
+    {
+        return (this->words[position / 64] >> (position % 64)) & 1;
+    }
+
+    void set(const std::size_t position, const bool value = true) noexcept
+    {
+        const Word bit{Word{1} << (position % 64)};
+
+        if (value)
+            this->words[position / 64] |= bit;
+        else
+            this->words[position / 64] &= ~bit;
+    }
+
+    /**
+     * @brief Set the cell at position and report whether it already was, in one lookup
+     *
+     * @param position
+     * @return true if the cell was already set
+     */
+    bool testAndSet(const std::size_t position) noexcept
+    {
+        Word& word{this->words[position / 64]};
+        const Word bit{Word{1} << (position % 64)};
+
+        const bool wasSet{(word & bit) != 0};
+        word |= bit;
+
+        return wasSet;
+    }
+
+    /**
+     * @brief Clear every cell, border included
+     *
+     */
+    void reset() noexcept
+    {
+        std::ranges::fill(this->words, 0);
+    }
+private:
+    using Word = std::uint64_t;
+
+    std::vector<Word> words;
+};
+
+/**
+ * @brief Grid of one cell per character of each line of text, with cell(c) giving the value of character c
+ *        std::runtime_error will be thrown if the lines are not all the same length
+ *
+ * @param text
+ * @param cell
+ * @param padding Cells of border on each side
+ * @param border Value of every border cell
+ * @return Grid<T>
+ */
+template <typename T, typename CellFunc>
+[[nodiscard]]
+Grid<T> parseGrid(const std::string_view text, CellFunc&& cell, const std::size_t padding = 0, const T& border = {})
+{
+    std::size_t width{};
+    std::size_t height{};
+    for (const std::string_view line : lines(text))
+    {
+        if (height != 0 && line.size() != width)
+            throw std::runtime_error{"Grid rows must all be the same length"};
+
+        width = line.size();
+        ++height;
+    }
+
+    Grid<T> grid(width, height, border, padding, border);
+
+    std::size_t y{};
+    for (const std::string_view line : lines(text))
+    {
+        for (std::size_t x{}; x < width; ++x)
+        {
+            grid(x, y) = cell(line[x]);
+        }
+
+        ++y;
+    }
+
+    return grid;
+}
+
+}
+
+#endif
\ No newline at end of file
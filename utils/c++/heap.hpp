@@ -0,0 +1,213 @@
+#ifndef AOC_CPP_HEAP_H
+#define AOC_CPP_HEAP_H
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * @brief Priority queue of dense ids in [0, capacity) that can lower the priority of a queued id in O(log n)
+ *        The position of every id is kept in a flat table, so nothing is hashed and nothing is allocated after
+ *        construction. Ids only take up space in the heap itself once they are pushed
+ *
+ * @tparam Priority
+ * @tparam Arity Children per node. Wider nodes make the heap shallower, which pays off when decreases outnumber pops
+ * @tparam Compare Strict weak order where Compare(a, b) means a comes out of the queue before b
+ */
+template <typename Priority, std::size_t Arity = 4, std::strict_weak_order<Priority, Priority> Compare = std::less<Priority>>
+class IndexedHeap
+{
+    static_assert(Arity >= 2, "A heap needs at least 2 children per node");
+public:
+    using Id = std::uint32_t;
+
+    explicit IndexedHeap(const std::size_t capacity, const Compare& a_comp = {}) :
+        positions(capacity, NOT_QUEUED), comp{a_comp}
+    {
+        this->heap.reserve(capacity);
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept
+    {
+        return this->heap.empty();
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept
+    {
+        return this->heap.size();
+    }
+
+    [[nodiscard]]
+    bool contains(const Id id) const noexcept
+    {
+        return this->positions[id] != NOT_QUEUED;
+    }
+
+    /**
+     * @brief Id that comes out next. The heap must not be empty
+     *
+     * @return Id
+     */
+    [[nodiscard]]
+    Id top() const noexcept
+    {
+        return this->heap.front().id;
+    }
+
+    [[nodiscard]]
+    const Priority& topPriority() const noexcept
+    {
+        return this->heap.front().priority;
+    }
+
+    /**
+     * @brief Queue an id that is not already queued
+     *
+     * @param id
+     * @param priority
+     */
+    void push(const Id id, Priority priority)
+    {
+        this->heap.emplace_back(std::move(priority), id);
+        this->siftUp(this->heap.size() - 1);
+    }
+
+    /**
+     * @brief Move a queued id closer to the top. The new priority must not come after the current one
+     *
+     * @param id
+     * @param priority
+     */
+    void decreaseKey(const Id id, Priority priority)
+    {
+        const std::size_t position{this->positions[id]};
+        this->heap[position].priority = std::move(priority);
+        this->siftUp(position);
+    }
+
+    /**
+     * @brief Queue id if it is not queued yet, otherwise decrease its priority if this one comes first
+     *
+     * @param id
+     * @param priority
+     * @return true if id was pushed or decreased, else false
+     */
+    bool pushOrDecrease(const Id id, Priority priority)
+    {
+        if (!this->contains(id))
+        {
+            this->push(id, std::move(priority));
+            return true;
+        }
+
+        if (!this->comp(priority, this->heap[this->positions[id]].priority))
+            return false;
+
+        this->decreaseKey(id, std::move(priority));
+        return true;
+    }
+
+    /**
+     * @brief Remove the top id. The heap must not be empty
+     *
+     */
+    void pop()
+    {
+        this->positions[this->heap.front().id] = NOT_QUEUED;
+
+        Entry last{std::move(this->heap.back())};
+        this->heap.pop_back();
+
+        if (!this->heap.empty())
+            this->siftDown(0, std::move(last));
+    }
+private:
+    static constexpr Id NOT_QUEUED{std::numeric_limits<Id>::max()};
+
+    struct Entry
+    {
+        Priority priority;
+        Id id{};
+    };
+
+    std::vector<Entry> heap;
+    std::vector<Id> positions;
+    Compare comp;
+
+    void place(const std::size_t position, Entry&& entry)
+    {
+        this->positions[entry.id] = static_cast<Id>(position);
+        this->heap[position] = std::move(entry);
+    }
+
+    /**
+     * @brief Move the entry at position up until its parent comes first. Parents are moved down into the hole
+     *        instead of swapping, so the entry itself is only written once
+     *
+     * @param position
+     */
+    void siftUp(std::size_t position)
+    {
+        Entry entry{std::move(this->heap[position])};
+
+        while (position != 0)
+        {
+            const std::size_t parent{(position - 1) / Arity};
+            if (!this->comp(entry.priority, this->heap[parent].priority))
+                break;
+
+            this->place(position, std::move(this->heap[parent]));
+            position = parent;
+        }
+
+        this->place(position, std::move(entry));
+    }
+
+    /**
+     * @brief Fill the hole at position with entry, moving the first of its children up while any comes before entry
+     *
+     * @param position
+     * @param entry
+     */
+    void siftDown(std::size_t position, Entry&& entry)
+    {
+        const std::size_t count{this->heap.size()};
+
+        while (true)
+        {
+            const std::size_t firstChild{position * Arity + 1};
+            if (firstChild >= count)
+                break;
+
+            const std::size_t lastChild{std::min(firstChild + Arity, count)};
+            std::size_t best{firstChild};
+            for (std::size_t child{firstChild + 1}; child < lastChild; ++child)
+            {
+                if (this->comp(this->heap[child].priority, this->heap[best].priority))
+                    best = child;
+            }
+
+            if (!this->comp(this->heap[best].priority, entry.priority))
+                break;
+
+            this->place(position, std::move(this->heap[best]));
+            position = best;
+        }
+
+        this->place(position, std::move(entry));
+    }
+};
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,301 @@
+#ifndef AOC_CPP_INPUT_H
+#define AOC_CPP_INPUT_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aoc
+{
+
+/**
+ * @brief Puzzle input loaded once and shared as a read only std::string_view
+ *        Regular files are memory mapped so no copy is made. Pipes, FIFOs and "-" for stdin are read into memory instead
+ *
+ */
+class InputFile
+{
+public:
+    /**
+     * @brief std::runtime_error will be thrown if the file can not be opened or read
+     *
+     * @param path File to load, or "-" for stdin
+     */
+    explicit InputFile(const std::string& path)
+    {
+        if (path == "-")
+        {
+            this->buffer = readAll(STDIN_FILENO, path);
+            return;
+        }
+
+        const int fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (fd == -1)
+            throw std::runtime_error{"Failed to open \"" + path + '"'};
+
+        struct stat info{};
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0)
+        {
+            const std::size_t fileSize{static_cast<std::size_t>(info.st_size)};
+
+            void* const mapped{::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0)};
+            if (mapped != MAP_FAILED)
+            {
+                // Solutions make one front to back pass, so let the kernel read ahead aggressively
+                ::madvise(mapped, fileSize, MADV_SEQUENTIAL);
+                ::close(fd);
+
+                this->mapping = mapped;
+                this->size = fileSize;
+                return;
+            }
+        }
+
+        try
+        {
+            this->buffer = readAll(fd, path);
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+
+        ::close(fd);
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    InputFile(InputFile&& other) noexcept :
+        mapping{std::exchange(other.mapping, nullptr)}, size{std::exchange(other.size, 0)}, buffer{std::move(other.buffer)}
+    {}
+
+    InputFile& operator=(InputFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            this->unmap();
+            this->mapping = std::exchange(other.mapping, nullptr);
+            this->size = std::exchange(other.size, 0);
+            this->buffer = std::move(other.buffer);
+        }
+
+        return *this;
+    }
+
+    ~InputFile()
+    {
+        this->unmap();
+    }
+
+    /**
+     * @brief Entire contents of the file. Valid for as long as this InputFile is alive
+     *
+     * @return std::string_view
+     */
+    [[nodiscard]]
+    std::string_view view() const noexcept
+    {
+        if (this->mapping != nullptr)
+            return {static_cast<const char*>(this->mapping), this->size};
+
+        return this->buffer;
+    }
+private:
+    void* mapping{nullptr};
+    std::size_t size{};
+
+    // Only used when the file could not be mapped
+    std::string buffer;
+
+    void unmap() noexcept
+    {
+        if (this->mapping != nullptr)
+            ::munmap(this->mapping, this->size);
+    }
+
+    [[nodiscard]]
+    static std::string readAll(const int fd, const std::string& path)
+    {
+        static constexpr std::size_t CHUNK_SIZE{1 << 16};
+
+        std::string contents;
+        std::size_t used{};
+
+        while (true)
+        {
+            contents.resize(used + CHUNK_SIZE);
+
+            const ssize_t count{::read(fd, contents.data() + used, CHUNK_SIZE)};
+            if (count == 0)
+                break;
+
+            if (count == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                throw std::runtime_error{"Failed to read \"" + path + "\": " + std::strerror(errno)};
+            }
+
+            used += static_cast<std::size_t>(count);
+        }
+
+        contents.resize(used);
+        return contents;
+    }
+};
+
+/**
+ * @brief Range over the lines of some text without copying or allocating. Matches std::getline: lines do not include
+ *        the '\n' and a final newline does not start an extra empty line
+ *
+ */
+class LineView : public std::ranges::view_interface<LineView>
+{
+public:
+    class iterator
+    {
+    public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        explicit iterator(const std::string_view text) :
+            rest{text}
+        {
+            this->advance();
+        }
+
+        [[nodiscard]]
+        std::string_view operator*() const noexcept
+        {
+            return this->line;
+        }
+
+        iterator& operator++() noexcept
+        {
+            this->advance();
+            return *this;
+        }
+
+        [[nodiscard]]
+        iterator operator++(const int) noexcept
+        {
+            iterator copy{*this};
+            this->advance();
+            return copy;
+        }
+
+        [[nodiscard]]
+        bool operator==(const iterator& rhs) const noexcept
+        {
+            return this->done == rhs.done && this->line.data() == rhs.line.data();
+        }
+
+        [[nodiscard]]
+        bool operator==(std::default_sentinel_t) const noexcept
+        {
+            return this->done;
+        }
+    private:
+        std::string_view rest;
+        std::string_view line;
+        bool done{false};
+
+        void advance() noexcept
+        {
+            if (this->rest.empty())
+            {
+                this->done = true;
+                this->line = {};
+                return;
+            }
+
+            const void* const newline{std::memchr(this->rest.data(), '\n', this->rest.size())};
+            const std::size_t length{newline == nullptr ? this->rest.size() : static_cast<std::size_t>(static_cast<const char*>(newline) - this->rest.data())};
+
+            this->line = this->rest.substr(0, length);
+            this->rest.remove_prefix(std::min(length + 1, this->rest.size()));
+        }
+    };
+
+    LineView() = default;
+
+    explicit LineView(const std::string_view a_text) :
+        text{a_text}
+    {}
+
+    [[nodiscard]]
+    iterator begin() const noexcept
+    {
+        return iterator{this->text};
+    }
+
+    [[nodiscard]]
+    std::default_sentinel_t end() const noexcept
+    {
+        return std::default_sentinel;
+    }
+private:
+    std::string_view text;
+};
+
+[[nodiscard]]
+inline LineView lines(const std::string_view text) noexcept
+{
+    return LineView{text};
+}
+
+/**
+ * @brief std::istream that reads straight out of a std::string_view, for parsing with operator>> without copying the
+ *        text into a std::istringstream first. The text must outlive the stream
+ *
+ */
+class InputStream : public std::istream
+{
+public:
+    explicit InputStream(const std::string_view text) :
+        std::istream{nullptr}, buffer{text}
+    {
+        this->rdbuf(&this->buffer);
+    }
+
+    // Never inlined so the -Winline builds of older solutions stay quiet
+    [[gnu::noinline]]
+    ~InputStream() override = default;
+private:
+    class Buffer : public std::streambuf
+    {
+    public:
+        explicit Buffer(const std::string_view text)
+        {
+            // The get area is only ever read from, so casting away const is safe even for read only mappings
+            char* const first{const_cast<char*>(text.data())};
+            this->setg(first, first, first + text.size());
+        }
+    };
+
+    Buffer buffer;
+};
+
+}
+
+#endif
\ No newline at end of file
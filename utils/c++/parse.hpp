@@ -0,0 +1,216 @@
+#ifndef AOC_CPP_PARSE_H
+#define AOC_CPP_PARSE_H
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "utils.hpp"
+
+namespace aoc
+{
+
+namespace detail
+{
+
+// GNU mode counts __int128 as an integral type, so fromChars accepts it too
+__extension__ using UnsignedInt128 = unsigned __int128;
+
+inline constexpr std::uint64_t EVERY_BYTE{0x0101010101010101};
+
+inline constexpr std::array<std::uint64_t, 9> POWERS_OF_10{1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000,
+    100'000'000};
+
+/**
+ * @brief Count the ASCII digits at the start of 8 bytes loaded little endian, and turn each digit byte into 0-9
+ *
+ * @param chunk
+ * @return unsigned int 0-8
+ */
+[[nodiscard]]
+inline constexpr unsigned int leadingDigits(std::uint64_t& chunk) noexcept
+{
+    chunk ^= EVERY_BYTE * '0';
+
+    // A byte is a digit if it is now below 10. Masking off the top bit first keeps the add from carrying between bytes
+    const std::uint64_t nonDigits{(((chunk & (EVERY_BYTE * 0x7F)) + EVERY_BYTE * (0x80 - 10)) | chunk) &
+        (EVERY_BYTE * 0x80)};
+
+    return static_cast<unsigned int>(std::countr_zero(nonDigits)) / 8;
+}
+
+/**
+ * @brief Value of 8 digits in 0-9, most significant in the lowest byte. Pairs of digits are combined, then pairs of
+ *        pairs, and so on, so this is 3 multiplies instead of 8
+ *
+ * @param digits
+ * @return std::uint64_t
+ */
+[[nodiscard]]
+inline constexpr std::uint64_t combineDigits(std::uint64_t digits) noexcept
+{
+    digits = (digits * 10 + (digits >> 8)) & 0x00FF00FF00FF00FF;
+    digits = (digits * 100 + (digits >> 16)) & 0x0000FFFF0000FFFF;
+    return (digits * 10'000 + (digits >> 32)) & 0xFFFFFFFF;
+}
+
+}
+
+/**
+ * @brief Drop in replacement for std::from_chars on integers in base 10 that reads 8 digits at a time
+ *        As with std::from_chars, only signed types accept a leading '-', there is no leading whitespace or '+',
+ *        and value is left unchanged on error. Works up to 128 bit types
+ *
+ * @param first
+ * @param last
+ * @param value
+ * @return std::from_chars_result
+ */
+template <std::integral T>
+std::from_chars_result fromChars(const char* const first, const char* const last, T& value) noexcept
+{
+    // Wide enough for the magnitude of any T
+    using Magnitude = std::conditional_t<(std::numeric_limits<T>::digits > 64), detail::UnsignedInt128, std::uint64_t>;
+
+    const char* current{first};
+
+    bool negative{false};
+    if constexpr (std::is_signed_v<T>)
+    {
+        if (current != last && *current == '-')
+        {
+            negative = true;
+            ++current;
+        }
+    }
+
+    const char* const digits{current};
+    Magnitude magnitude{0};
+    bool overflow{false};
+
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        while (last - current >= 8)
+        {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, current, sizeof(chunk));
+
+            const unsigned int count{detail::leadingDigits(chunk)};
+            if (count == 0)
+                break;
+
+            // Shifting the digits to the top of the chunk drops whatever followed them and leaves leading zeros behind
+            const std::uint64_t chunkValue{detail::combineDigits(chunk << (64 - 8 * count))};
+            if (__builtin_mul_overflow(magnitude, detail::POWERS_OF_10[count], &magnitude) ||
+                __builtin_add_overflow(magnitude, chunkValue, &magnitude))
+                overflow = true;
+
+            current += count;
+            if (count < 8)
+                break;
+        }
+    }
+
+    for (; current != last && *current >= '0' && *current <= '9'; ++current)
+    {
+        if (__builtin_mul_overflow(magnitude, 10, &magnitude) ||
+            __builtin_add_overflow(magnitude, static_cast<unsigned int>(*current - '0'), &magnitude))
+            overflow = true;
+    }
+
+    if (current == digits)
+        return {first, std::errc::invalid_argument};
+
+    // The most negative value has one more than the largest positive magnitude
+    const Magnitude limit{static_cast<Magnitude>(std::numeric_limits<T>::max()) + (negative ? 1 : 0)};
+    if (overflow || magnitude > limit)
+        return {current, std::errc::result_out_of_range};
+
+    value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+    return {current, std::errc{}};
+}
+
+/**
+ * @brief Parse a string that is nothing but one integer. std::runtime_error will be thrown if it is not
+ *
+ * @param str
+ * @return T
+ */
+template <std::integral T>
+[[nodiscard]]
+T parseInt(const std::string_view str)
+{
+    const char* const last{str.data() + str.size()};
+
+    T value{};
+    const auto[end, error]{fromChars(str.data(), last, value)};
+    if (error != std::errc{} || end != last)
+        throw std::runtime_error{"Failed to parse \"" + std::string{str} + "\" as an integer"};
+
+    return value;
+}
+
+/**
+ * @brief Append every integer in text to values, skipping whatever separates them
+ *        When T is signed a '-' right before a number makes it negative, so "1-2" is 1 and -2
+ *        std::runtime_error will be thrown if a number does not fit in T
+ *
+ * @param text
+ * @param values
+ */
+template <std::integral T>
+void parseInts(const std::string_view text, std::vector<T>& values)
+{
+    static constexpr ByteSet DIGITS{"0123456789"};
+
+    const char* current{text.data()};
+    const char* const last{current + text.size()};
+
+    while ((current = DIGITS.find(current, last)) != last)
+    {
+        const char* first{current};
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (first != text.data() && first[-1] == '-')
+                --first;
+        }
+
+        T value{};
+        const auto[end, error]{fromChars(first, last, value)};
+        if (error != std::errc{})
+            throw std::runtime_error{"\"" + std::string{first, end} + "\" is out of range"};
+
+        values.push_back(value);
+        current = end;
+    }
+}
+
+/**
+ * @brief Every integer in text, see parseInts(text, values)
+ *
+ * @param text
+ * @return std::vector<T>
+ */
+template <std::integral T>
+[[nodiscard]]
+std::vector<T> parseInts(const std::string_view text)
+{
+    std::vector<T> values;
+    parseInts(text, values);
+
+    return values;
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef AOC_CPP_SIMD_H
+#define AOC_CPP_SIMD_H
+
+#include <cstdlib>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AOC_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace aoc::simd
+{
+
+/**
+ * @brief Widest instruction set a vectorized kernel may use, in increasing order
+ *
+ */
+enum class Level
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief Instruction set to dispatch kernels to. Detected once from the CPU, and can be lowered for testing and
+ *        benchmarking by setting the AOC_SIMD environment variable to "scalar", "sse2" or "avx2"
+ *
+ * @return Level
+ */
+[[nodiscard]]
+inline Level level() noexcept
+{
+    static const Level detected{[]() -> Level
+    {
+        Level supported{Level::Scalar};
+
+#ifdef AOC_SIMD_X86
+        if (__builtin_cpu_supports("avx2"))
+            supported = Level::AVX2;
+        else if (__builtin_cpu_supports("sse2"))
+            supported = Level::SSE2;
+#endif
+
+        const char* const requested{std::getenv("AOC_SIMD")};
+        if (requested == nullptr)
+            return supported;
+
+        const std::string_view name{requested};
+        const Level cap{name == "scalar" ? Level::Scalar : name == "sse2" ? Level::SSE2 : Level::AVX2};
+
+        return cap < supported ? cap : supported;
+    }()};
+
+    return detected;
+}
+
+}
+
+#endif
\ No newline at end of file
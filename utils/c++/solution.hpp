@@ -0,0 +1,141 @@
+#ifndef AOC_CPP_SOLUTION_H
+#define AOC_CPP_SOLUTION_H
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "input.hpp"
+
+namespace aoc
+{
+
+/**
+ * @brief Entry point of one part of one puzzle. Takes the entire input file and returns the answer as text
+ *        Errors in the input are reported by throwing std::runtime_error
+ */
+using SolveFunc = std::string(*)(std::string_view input);
+
+struct Solution
+{
+    int year{};
+    int day{};
+    int part{};
+    std::string_view name;
+
+    // Input file relative to the root of the repository
+    std::string_view inputFile;
+
+    SolveFunc solve{};
+};
+
+/**
+ * @brief List of every solution linked into the current binary. Filled by AOC_SOLUTION during static initialization
+ *
+ * @return std::vector<Solution>&
+ */
+[[nodiscard]]
+inline std::vector<Solution>& solutions()
+{
+    static std::vector<Solution> registered;
+    return registered;
+}
+
+struct SolutionRegistrar
+{
+    SolutionRegistrar(const Solution& solution)
+    {
+        solutions().push_back(solution);
+    }
+};
+
+/**
+ * @brief Receives the phase boundaries marked by a solution while it is being benchmarked
+ *
+ */
+class PhaseRecorder
+{
+public:
+    virtual ~PhaseRecorder() = default;
+
+    virtual void begin(std::string_view phase) = 0;
+};
+
+/**
+ * @brief Recorder for solutions running on this thread, or nullptr when nothing is being measured
+ *
+ * @return PhaseRecorder*&
+ */
+[[nodiscard]]
+inline PhaseRecorder*& phaseRecorder()
+{
+    static thread_local PhaseRecorder* recorder{nullptr};
+    return recorder;
+}
+
+/**
+ * @brief Mark the start of a phase of a solution such as "parse" or "solve". Work before the first mark belongs to the
+ *        first marked phase and a solution that marks nothing is all "solve". Only the benchmark harness looks at phases,
+ *        so this does nothing the rest of the time
+ *
+ * @param phase Must outlive the benchmark, string literals are expected
+ */
+inline void beginPhase(const std::string_view phase)
+{
+    if (PhaseRecorder* const recorder{phaseRecorder()}; recorder != nullptr)
+        recorder->begin(phase);
+}
+
+/**
+ * @brief main() for a solution built on its own. Reads the file given as the only argument, or input.txt if there is none. "-" reads stdin
+ *
+ * @param argc
+ * @param argv
+ * @param solve
+ * @return int
+ */
+// Never inlined so the -Winline builds of older solutions stay quiet
+[[gnu::noinline]]
+inline int runStandalone(const int argc, const char** const argv, const SolveFunc solve)
+{
+    if (argc > 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " [INPUT_FILE]\n";
+        return 1;
+    }
+
+    try
+    {
+        const InputFile input{argc == 2 ? argv[1] : "input.txt"};
+        const std::string answer{solve(input.view())};
+
+        // Multi-line answers start on their own line
+        std::cout << (answer.find('\n') == std::string::npos ? "Result: " : "Result:\n") << answer << '\n';
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "ERROR! " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
+}
+
+// Registers solve with the aoc runner, or defines main() when the solution is built on its own
+// AOC_YEAR, AOC_DAY, AOC_PART, AOC_NAME and AOC_INPUT_FILE are set per source file by the top level CMakeLists.txt
+#ifdef AOC_RUNNER
+#define AOC_SOLUTION(solve) \
+    static const aoc::SolutionRegistrar aocSolutionRegistrar{{AOC_YEAR, AOC_DAY, AOC_PART, AOC_NAME, AOC_INPUT_FILE, solve}};
+#else
+#define AOC_SOLUTION(solve) \
+    int main(const int argc, const char** const argv) \
+    { \
+        return aoc::runStandalone(argc, argv, solve); \
+    }
+#endif
+
+#endif
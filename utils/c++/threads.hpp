@@ -0,0 +1,234 @@
+#ifndef AOC_CPP_THREADS_H
+#define AOC_CPP_THREADS_H
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace aoc
+{
+
+/**
+ * @brief Number of threads parallel solutions should use. Every hardware thread by default, or the count in the
+ *        AOC_THREADS environment variable, which the runner's --threads sets. Read once
+ *
+ * @return std::size_t At least 1
+ */
+[[nodiscard]]
+inline std::size_t threadCount() noexcept
+{
+    static const std::size_t count{[]() -> std::size_t
+    {
+        const char* const requested{std::getenv("AOC_THREADS")};
+        if (requested != nullptr)
+        {
+            const std::string_view text{requested};
+
+            std::size_t value{};
+            const auto[last, error]{std::from_chars(text.data(), text.data() + text.size(), value)};
+            if (error == std::errc{} && last == text.data() + text.size() && value > 0)
+                return value;
+        }
+
+        return std::max(std::thread::hardware_concurrency(), 1U);
+    }()};
+
+    return count;
+}
+
+/**
+ * @brief Fixed set of worker threads running tasks from a shared queue
+ *        The thread that waits on the pool runs tasks as well, so a pool of size n starts n - 1 workers and a pool of
+ *        size 1 runs everything on the caller
+ *
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(const std::size_t size = threadCount())
+    {
+        for (std::size_t i{1}; i < size; ++i)
+        {
+            this->workers.emplace_back([this]() -> void
+            {
+                this->work();
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            const std::lock_guard lock{this->mutex};
+            this->stopping = true;
+        }
+        this->wake.notify_all();
+
+        for (std::thread& worker : this->workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Threads that run tasks, counting the one that waits
+     *
+     * @return std::size_t
+     */
+    [[nodiscard]]
+    std::size_t size() const noexcept
+    {
+        return this->workers.size() + 1;
+    }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            const std::lock_guard lock{this->mutex};
+            this->tasks.push_back(std::move(task));
+            ++this->unfinished;
+        }
+        this->wake.notify_one();
+    }
+
+    /**
+     * @brief Help run queued tasks until every submitted task has finished
+     *        The first exception thrown by any of them is rethrown here once they have all finished
+     *
+     */
+    void wait()
+    {
+        std::unique_lock lock{this->mutex};
+
+        while (this->unfinished != 0)
+        {
+            if (this->tasks.empty())
+                this->finished.wait(lock);
+            else
+                this->runFront(lock);
+        }
+
+        if (this->error != nullptr)
+            std::rethrow_exception(std::exchange(this->error, nullptr));
+    }
+
+    /**
+     * @brief Call func(i) for every i in [0, count) across the pool and wait for all of them
+     *        Indices are handed out one at a time as threads free up, so uneven work still spreads evenly
+     *
+     * @param count
+     * @param func
+     */
+    template <typename Func>
+    void parallelFor(const std::size_t count, Func&& func)
+    {
+        std::atomic<std::size_t> next{0};
+
+        for (std::size_t i{std::min(count, this->size())}; i > 0; --i)
+        {
+            this->submit([&next, &func, count]() -> void
+            {
+                for (std::size_t index{next++}; index < count; index = next++)
+                {
+                    func(index);
+                }
+            });
+        }
+
+        this->wait();
+    }
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+    std::size_t unfinished{};
+    std::exception_ptr error;
+    bool stopping{false};
+
+    // Signalled when a task is queued or the pool is stopping
+    std::condition_variable wake;
+    // Signalled when the last unfinished task finishes
+    std::condition_variable finished;
+
+    /**
+     * @brief Run the task at the front of the queue. lock must be held, and is released while the task runs
+     *
+     * @param lock
+     */
+    void runFront(std::unique_lock<std::mutex>& lock)
+    {
+        std::function<void()> task{std::move(this->tasks.front())};
+        this->tasks.pop_front();
+
+        lock.unlock();
+
+        std::exception_ptr thrown;
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            thrown = std::current_exception();
+        }
+
+        lock.lock();
+
+        if (thrown != nullptr && this->error == nullptr)
+            this->error = thrown;
+
+        if (--this->unfinished == 0)
+            this->finished.notify_all();
+    }
+
+    void work()
+    {
+        std::unique_lock lock{this->mutex};
+
+        while (true)
+        {
+            this->wake.wait(lock, [this]() -> bool
+            {
+                return this->stopping || !this->tasks.empty();
+            });
+
+            if (this->tasks.empty())
+                return;
+
+            this->runFront(lock);
+        }
+    }
+};
+
+/**
+ * @brief Pool of threadCount() threads shared by every solution, so repeated benchmark runs do not start threads each
+ *        time. Only one thread may use it at a time
+ *
+ * @return ThreadPool&
+ */
+[[nodiscard]]
+inline ThreadPool& threadPool()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -1,22 +1,316 @@
 #ifndef AOC_CPP_UTILS_H
 #define AOC_CPP_UTILS_H
 
+#include <algorithm>
 #include <array>
-#include <cctype>
+#include <bit>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "simd.hpp"
+
 template <typename T>
 inline constexpr bool alwaysFalse(const T&) noexcept
 {
     return false;
 }
 
-template <std::predicate<char> StopCharFunc = decltype(&alwaysFalse<char>)>
+/**
+ * @brief Same as std::isspace in the "C" locale, without looking up the current locale for every character
+ *
+ * @param c
+ * @return true if c is ' ', '\t', '\n', '\v', '\f' or '\r'
+ */
+[[nodiscard]]
+inline constexpr bool isSpace(const char c) noexcept
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/**
+ * @brief Set of byte values that can be searched for 16 or 32 bytes at a time. Also usable as a StopCharFunc for SplitView
+ *
+ */
+class ByteSet
+{
+public:
+    // Bytes classified at once by mask()
+    static constexpr std::size_t BLOCK_SIZE{64};
+
+    constexpr ByteSet() = default;
+
+    constexpr ByteSet(const std::string_view members)
+    {
+        for (const char c : members)
+        {
+            this->insert(c);
+        }
+    }
+
+    constexpr void insert(const char c) noexcept
+    {
+        const unsigned char byte{static_cast<unsigned char>(c)};
+        this->bits_[byte / 64] |= std::uint64_t{1} << (byte % 64);
+        this->updateRanges();
+    }
+
+    [[nodiscard]]
+    constexpr bool contains(const char c) const noexcept
+    {
+        const unsigned char byte{static_cast<unsigned char>(c)};
+        return (this->bits_[byte / 64] >> (byte % 64)) & 1;
+    }
+
+    [[nodiscard]]
+    constexpr bool operator()(const char c) const noexcept
+    {
+        return this->contains(c);
+    }
+
+    [[nodiscard]]
+    constexpr ByteSet operator|(const ByteSet& rhs) const noexcept
+    {
+        ByteSet result;
+        for (std::size_t i{}; i < result.bits_.size(); ++i)
+        {
+            result.bits_[i] = this->bits_[i] | rhs.bits_[i];
+        }
+        result.updateRanges();
+
+        return result;
+    }
+
+    /**
+     * @brief Find the first member of this set in [first, last)
+     *
+     * @param first
+     * @param last
+     * @return const char* Pointer to the first member found, or last if there is none
+     */
+    [[nodiscard]]
+    const char* find(const char* first, const char* const last) const noexcept
+    {
+#ifdef AOC_SIMD_X86
+        // Sets made of many separate runs are cheaper to check with the bitmap than with one compare per run
+        if (this->rangeCount_ <= MAX_RANGES)
+        {
+            switch (aoc::simd::level())
+            {
+            case aoc::simd::Level::AVX2:
+                first = this->findAvx2(first, last);
+                break;
+            case aoc::simd::Level::SSE2:
+                first = this->findSse2(first, last);
+                break;
+            case aoc::simd::Level::Scalar:
+                break;
+            }
+        }
+#endif
+
+        while (first != last && !this->contains(*first))
+        {
+            ++first;
+        }
+
+        return first;
+    }
+
+    /**
+     * @brief Whether find() and mask() check 16 or 32 bytes at a time rather than one at a time
+     *
+     * @return bool
+     */
+    [[nodiscard]]
+    bool vectorized() const noexcept
+    {
+#ifdef AOC_SIMD_X86
+        return this->rangeCount_ <= MAX_RANGES && aoc::simd::level() != aoc::simd::Level::Scalar;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Which of the BLOCK_SIZE bytes from first are members of this set. They must all be readable
+     *
+     * @param first
+     * @return std::uint64_t Bit i is set when first[i] is a member
+     */
+    [[nodiscard]]
+    std::uint64_t mask(const char* const first) const noexcept
+    {
+#ifdef AOC_SIMD_X86
+        if (this->rangeCount_ <= MAX_RANGES)
+        {
+            switch (aoc::simd::level())
+            {
+            case aoc::simd::Level::AVX2:
+                return this->maskAvx2(first);
+            case aoc::simd::Level::SSE2:
+                return this->maskSse2(first);
+            case aoc::simd::Level::Scalar:
+                break;
+            }
+        }
+#endif
+
+        std::uint64_t result{};
+        for (std::size_t i{}; i < BLOCK_SIZE; ++i)
+        {
+            result |= std::uint64_t{this->contains(first[i])} << i;
+        }
+
+        return result;
+    }
+private:
+    static constexpr std::size_t MAX_RANGES{8};
+
+    std::array<std::uint64_t, 4> bits_{};
+
+    // Members as inclusive runs of consecutive byte values. rangeCount_ is MAX_RANGES + 1 when there are too many runs
+    std::array<std::pair<unsigned char, unsigned char>, MAX_RANGES> ranges_{};
+    std::size_t rangeCount_{};
+
+    constexpr void updateRanges() noexcept
+    {
+        this->rangeCount_ = 0;
+
+        for (unsigned int byte{}; byte < 256;)
+        {
+            if (!this->contains(static_cast<char>(byte)))
+            {
+                ++byte;
+                continue;
+            }
+
+            const unsigned int low{byte};
+            while (byte < 256 && this->contains(static_cast<char>(byte)))
+            {
+                ++byte;
+            }
+
+            if (this->rangeCount_ == MAX_RANGES)
+            {
+                this->rangeCount_ = MAX_RANGES + 1;
+                return;
+            }
+
+            this->ranges_[this->rangeCount_++] = {static_cast<unsigned char>(low), static_cast<unsigned char>(byte - 1)};
+        }
+    }
+
+#ifdef AOC_SIMD_X86
+    // Bytes within a run are the ones left unchanged by clamping them to that run
+
+    [[gnu::target("sse2")]]
+    __m128i matchesSse2(const __m128i bytes) const noexcept
+    {
+        __m128i matches{_mm_setzero_si128()};
+        for (std::size_t i{}; i < this->rangeCount_; ++i)
+        {
+            const __m128i low{_mm_set1_epi8(static_cast<char>(this->ranges_[i].first))};
+            const __m128i high{_mm_set1_epi8(static_cast<char>(this->ranges_[i].second))};
+            const __m128i clamped{_mm_min_epu8(_mm_max_epu8(bytes, low), high)};
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi8(clamped, bytes));
+        }
+
+        return matches;
+    }
+
+    [[gnu::target("avx2")]]
+    __m256i matchesAvx2(const __m256i bytes) const noexcept
+    {
+        __m256i matches{_mm256_setzero_si256()};
+        for (std::size_t i{}; i < this->rangeCount_; ++i)
+        {
+            const __m256i low{_mm256_set1_epi8(static_cast<char>(this->ranges_[i].first))};
+            const __m256i high{_mm256_set1_epi8(static_cast<char>(this->ranges_[i].second))};
+            const __m256i clamped{_mm256_min_epu8(_mm256_max_epu8(bytes, low), high)};
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(clamped, bytes));
+        }
+
+        return matches;
+    }
+
+    // Both kernels stop at the first block containing a member, or leave the final partial block to the scalar loop in find()
+
+    [[gnu::target("sse2")]]
+    const char* findSse2(const char* first, const char* const last) const noexcept
+    {
+        for (; last - first >= 16; first += 16)
+        {
+            const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(first))};
+
+            const unsigned int found{static_cast<unsigned int>(_mm_movemask_epi8(this->matchesSse2(bytes)))};
+            if (found != 0)
+                return first + std::countr_zero(found);
+        }
+
+        return first;
+    }
+
+    [[gnu::target("avx2")]]
+    const char* findAvx2(const char* first, const char* const last) const noexcept
+    {
+        for (; last - first >= 32; first += 32)
+        {
+            const __m256i bytes{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first))};
+
+            const unsigned int found{static_cast<unsigned int>(_mm256_movemask_epi8(this->matchesAvx2(bytes)))};
+            if (found != 0)
+                return first + std::countr_zero(found);
+        }
+
+        return this->findSse2(first, last);
+    }
+
+    [[gnu::target("sse2")]]
+    std::uint64_t maskSse2(const char* const first) const noexcept
+    {
+        std::uint64_t result{};
+        for (std::size_t i{}; i < BLOCK_SIZE; i += 16)
+        {
+            const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + i))};
+            result |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(this->matchesSse2(bytes)))} << i;
+        }
+
+        return result;
+    }
+
+    [[gnu::target("avx2")]]
+    std::uint64_t maskAvx2(const char* const first) const noexcept
+    {
+        std::uint64_t result{};
+        for (std::size_t i{}; i < BLOCK_SIZE; i += 32)
+        {
+            const __m256i bytes{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i))};
+            result |= std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(this->matchesAvx2(bytes)))} << i;
+        }
+
+        return result;
+    }
+#endif
+};
+
+// Characters matched by isSpace()
+inline constexpr std::string_view WHITESPACE{" \t\n\v\f\r"};
+inline constexpr ByteSet WHITESPACE_BYTES{WHITESPACE};
+
+/**
+ * @brief Splits a string into tokens separated by whitespace. Every stop char is also returned as a token of its own
+ *        With a vectorized ByteSet StopCharFunc the iterator classifies ByteSet::BLOCK_SIZE bytes at a time into masks
+ *        of whitespace and delimiters, and finds where tokens start and end from the masks until they run out.
+ *        Otherwise each character is checked in turn
+ *
+ */
+template <std::predicate<char> StopCharFunc = ByteSet>
 class SplitView
 {
 public:
@@ -25,8 +319,8 @@ public:
     public:
         using difference_type = std::ptrdiff_t;
 
-        constexpr iterator(const SplitView& owner, const bool end = false) : 
-            current_{end ? owner.str_.end() : owner.str_.begin()}, owner_{&owner}
+        constexpr iterator(const SplitView& owner, const bool end = false) :
+            current_{end ? owner.last() : owner.first()}, owner_{&owner}
         {
             update();
         }
@@ -56,85 +350,215 @@ public:
         }
 
         [[nodiscard]]
-        constexpr bool operator==(const iterator& rhs)
+        constexpr bool operator==(const iterator& rhs) const
         {
             return this->current_ == rhs.current_ && this->value_.empty() == rhs.value_.empty();
         }
     private:
         void update()
         {
-            this->value_ = {};
-
-            std::string_view::iterator stop{this->current_};
+            const char* const last{this->owner_->last()};
 
-            while (stop != this->owner_->str_.end())
+            if constexpr (std::same_as<StopCharFunc, ByteSet>)
             {
-                if (this->owner_->isStopChar_(*stop) || std::isspace(*stop))
-                {
-                    if (stop != this->current_)
-                    {
-                        this->value_ = std::string_view(this->current_, stop);
-                        this->current_ = stop;
-                        break;
-                    }
-                    else if (!std::isspace(*stop))
-                    {
-                        this->value_ = std::string_view{this->current_, this->current_ + 1};
-                        ++this->current_;
-                        stop = this->current_;
-                        break;
-                    }
-                    else
-                    {
-                        ++stop;
-                        this->current_ = stop;
-                    }
-                }
-                else
+                if (this->owner_->blockwise_)
                 {
-                    ++stop;
+                    this->updateBlockwise();
+                    return;
                 }
             }
 
-            if (stop != this->current_)
+            while (this->current_ != last && isSpace(*this->current_))
+            {
+                ++this->current_;
+            }
+
+            if (this->current_ == last)
             {
-                this->value_ = std::string_view(this->current_, stop);
-                this->current_ = stop;
+                this->value_ = {};
+                return;
             }
+
+            // Stop chars are tokens of their own
+            const char* stop{this->current_ + 1};
+            if (!this->owner_->isStopChar_(*this->current_))
+                stop = this->owner_->findDelimiter(stop, last);
+
+            this->value_ = std::string_view(this->current_, static_cast<std::size_t>(stop - this->current_));
+            this->current_ = stop;
+        }
+
+        /**
+         * @brief update() from the masks of the current block
+         *
+         */
+        void updateBlockwise() noexcept
+        {
+            const char* const last{this->owner_->last()};
+
+            const char* const start{this->template scan<false>(this->current_)};
+            if (start == last)
+            {
+                this->current_ = last;
+                this->value_ = {};
+                return;
+            }
+
+            // Stop chars are tokens of their own, and the only delimiters that are not whitespace
+            const char* stop{start + 1};
+            if (((this->delimiters_ >> (start - this->block_)) & 1) == 0)
+                stop = this->template scan<true>(stop);
+
+            this->value_ = std::string_view(start, static_cast<std::size_t>(stop - start));
+            this->current_ = stop;
+        }
+
+        /**
+         * @brief First delimiter, or first byte that is not whitespace, from position on, loading blocks as needed
+         *
+         * @tparam Delimiter Whether to find a delimiter rather than the start of a token
+         * @param position
+         * @return const char* Last of the owner if there is none
+         */
+        template <bool Delimiter>
+        [[nodiscard]]
+        const char* scan(const char* position) noexcept
+        {
+            const char* const last{this->owner_->last()};
+
+            while (position < last)
+            {
+                if (this->block_ == nullptr || static_cast<std::size_t>(position - this->block_) >= ByteSet::BLOCK_SIZE)
+                    this->load(position);
+
+                const std::uint64_t blockMask{Delimiter ? this->delimiters_ : this->nonSpaces_};
+                const std::uint64_t found{blockMask >> (position - this->block_)};
+                if (found != 0)
+                    return std::min(position + std::countr_zero(found), last);
+
+                position = this->block_ + ByteSet::BLOCK_SIZE;
+            }
+
+            return last;
+        }
+
+        /**
+         * @brief Classify the block starting at position
+         *
+         * @param position
+         */
+        void load(const char* const position) noexcept
+        {
+            const char* const last{this->owner_->last()};
+
+            // The final partial block is padded with whitespace, which ends the last token at last
+            std::array<char, ByteSet::BLOCK_SIZE> padded;
+            const char* bytes{position};
+            if (static_cast<std::size_t>(last - position) < ByteSet::BLOCK_SIZE)
+            {
+                padded.fill(' ');
+                std::copy(position, last, padded.begin());
+                bytes = padded.data();
+            }
+
+            this->block_ = position;
+            this->nonSpaces_ = ~WHITESPACE_BYTES.mask(bytes);
+            this->delimiters_ = this->owner_->delimiters_.mask(bytes);
         }
 
         std::string_view value_;
-        std::string_view::iterator current_;
+        const char* current_{};
         const SplitView<StopCharFunc>* owner_{};
+
+        // Block of the input classified last, with bit i of each mask for block_[i]
+        const char* block_{};
+        std::uint64_t nonSpaces_{};
+        std::uint64_t delimiters_{};
     };
 
     SplitView(const std::string_view str) :
         str_{str}
-    {}
+    {
+        this->initDelimiters();
+    }
 
     template <typename T>
     SplitView(const std::string_view str, T&& isStopChar) :
         str_{str}, isStopChar_{std::forward<T>(isStopChar)}
-    {}
+    {
+        this->initDelimiters();
+    }
 
     [[nodiscard]]
-    constexpr iterator begin()
+    constexpr iterator begin() const
     {
         return {*this};
     }
 
     [[nodiscard]]
-    constexpr iterator end()
+    constexpr iterator end() const
     {
         return {*this, true};
     }
 private:
     std::string_view str_;
-    StopCharFunc isStopChar_{alwaysFalse<char>};
+    StopCharFunc isStopChar_{};
+
+    // Whitespace and stop chars together, so the end of a token is one ByteSet search
+    ByteSet delimiters_;
+
+    // Whether iterators find tokens from masks of whole blocks, which only pays off when the masks are vectorized
+    bool blockwise_{false};
+
+    [[nodiscard]]
+    const char* first() const noexcept
+    {
+        return this->str_.data();
+    }
+
+    [[nodiscard]]
+    const char* last() const noexcept
+    {
+        return this->str_.data() + this->str_.size();
+    }
+
+    void initDelimiters()
+    {
+        if constexpr (std::same_as<StopCharFunc, ByteSet>)
+        {
+            this->delimiters_ = WHITESPACE_BYTES | this->isStopChar_;
+            this->blockwise_ = this->delimiters_.vectorized();
+        }
+    }
+
+    /**
+     * @brief Find the first whitespace or stop char in [first, last)
+     *
+     * @param first
+     * @param last
+     * @return const char* last if there is none
+     */
+    [[nodiscard]]
+    const char* findDelimiter(const char* first, const char* const last) const
+    {
+        if constexpr (std::same_as<StopCharFunc, ByteSet>)
+        {
+            return this->delimiters_.find(first, last);
+        }
+        else
+        {
+            while (first != last && !isSpace(*first) && !this->isStopChar_(*first))
+            {
+                ++first;
+            }
+
+            return first;
+        }
+    }
 };
 
 template <typename T>
 SplitView(const std::string_view str, T&& isStopChar)
-    -> SplitView<T>;
+    -> SplitView<std::remove_cvref_t<T>>;
 
 #endif
\ No newline at end of file
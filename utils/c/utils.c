@@ -4,88 +4,91 @@
 
 #include "utils.h"
 
-void lineBufferCreate(LineBuffer* const this)
+// Lines longer than this grow the buffer
+#define LINE_READER_INITIAL_CAPACITY ((size_t)1 << 16)
+
+void lineReaderCreate(LineReader* const this, FILE* const file)
 {
+    this->file = file;
+    this->buffer = malloc(LINE_READER_INITIAL_CAPACITY);
+    this->capacity = LINE_READER_INITIAL_CAPACITY;
+    this->begin = 0;
+    this->end = 0;
+    this->eof = false;
     this->line = NULL;
     this->size = 0;
-    this->capacity = 0;
 }
 
-void lineBufferDestroy(LineBuffer* const this)
+void lineReaderDestroy(LineReader* const this)
 {
-    free(this->line);
+    free(this->buffer);
 }
 
-size_t nextLineSize(FILE* const file)
+/**
+ * @brief Move unread bytes to the front of the buffer and fill the rest from the file. Never seeks, so pipes work
+ * 
+ * @param this 
+ */
+static void lineReaderFill(LineReader* const this)
 {
-    // Record starting position to restore later
-    const long int starting = ftell(file);
-    if (starting == -1)
+    const size_t unread = this->end - this->begin;
+
+    if (this->begin > 0)
     {
-        perror("ftell() failed");
-        return (size_t)-1;
+        memmove(this->buffer, this->buffer + this->begin, unread);
+        this->begin = 0;
+        this->end = unread;
     }
 
-    size_t size = 0;
-    
-    // Count characters until newline or EOF
-    for (int c = fgetc(file); c != '\n' && c != EOF; c = fgetc(file))
+    // Always leave room to terminate a final line that has no newline
+    if (this->end + 1 >= this->capacity)
     {
-        ++size;
+        this->capacity *= 2;
+        this->buffer = realloc(this->buffer, this->capacity);
     }
 
-    // Restore starting file position
-    if (fseek(file, starting, SEEK_SET) != 0)
-        return (size_t)-1;
-    
-    return size;
+    const size_t count = fread(this->buffer + this->end, sizeof(char), this->capacity - 1 - this->end, this->file);
+    if (count == 0)
+        this->eof = true;
+
+    this->end += count;
 }
 
-bool readNextLine(FILE* const file, LineBuffer* const buffer)
+bool lineReaderNext(LineReader* const this)
 {
-    const size_t needed = nextLineSize(file);
-    if (needed == (size_t)-1)
-        return false;
-
-    buffer->size = needed;
-    
-    if (buffer->capacity < needed + 1)
+    while (true)
     {
-        buffer->line = realloc(buffer->line, sizeof(char) * needed + 1);
-        buffer->capacity = needed + 1;
-    }
+        char* const start = this->buffer + this->begin;
+        char* const newline = memchr(start, '\n', this->end - this->begin);
 
-    if (fread(buffer->line, sizeof(char), needed + 1, file) != needed + 1)
-        return false;
+        if (newline != NULL)
+        {
+            *newline = '\0';
 
-    buffer->line[needed] = '\0';
-    
-    return true;
-}
+            this->line = start;
+            this->size = (size_t)(newline - start);
+            this->begin += this->size + 1;
 
-size_t countLines(FILE* const file)
-{
-    // Record starting position to restore later
-    const long int starting = ftell(file);
-    if (starting == -1)
-    {
-        perror("ftell() failed");
-        return (size_t)-1;
-    }
+            return true;
+        }
 
-    size_t count = 1;
+        if (this->eof)
+        {
+            if (this->begin == this->end)
+                return false;
 
-    for (int c = fgetc(file); c != EOF; c = fgetc(file))
-    {
-        if (c == '\n')
-            ++count;
-    }
+            // Final line without a trailing newline
+            this->buffer[this->end] = '\0';
 
-    // Restore starting file position
-    if (fseek(file, starting, SEEK_SET) != 0)
-        return (size_t)-1;
+            this->line = start;
+            this->size = this->end - this->begin;
+            this->begin = this->end;
 
-    return count;
+            return true;
+        }
+
+        lineReaderFill(this);
+    }
 }
 
 void bstMapNodeCreate(struct BSTMapNode* const this, void* const key, void* const value)
@@ -2,19 +2,30 @@
 #define AOC_C_UTILS_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
 
 typedef struct
 {
-    char* line;
-    size_t size;
+    FILE* file;
+
+    // Bytes read from file but not yet returned as lines are buffer[begin, end)
+    char* buffer;
     size_t capacity;
-} LineBuffer;
+    size_t begin;
+    size_t end;
 
-void lineBufferCreate(LineBuffer* this);
-void lineBufferDestroy(LineBuffer* this);
-bool readNextLine(FILE* file, LineBuffer* buffer);
+    bool eof;
+
+    // Current line. Points into buffer with its '\n' replaced by '\0', so it can be used with strtok and sscanf
+    // Only valid until the next call to lineReaderNext()
+    char* line;
+    size_t size;
+} LineReader;
 
-size_t countLines(FILE* file);
+void lineReaderCreate(LineReader* this, FILE* file);
+void lineReaderDestroy(LineReader* this);
+bool lineReaderNext(LineReader* this);
 
 struct BSTMapNode
 {